@@ -1,7 +1,10 @@
 #pragma once
 
+#include "../../src/archetype_manager.hpp"
+#include "../../src/command_buffer.hpp"
 #include "../../src/components.hpp"
 #include "../../src/entity_component_manager.hpp"
+#include "../../src/scheduler.hpp"
 #include "../../src/sparse_set.hpp"
 #include "../../src/tags.hpp"
 
@@ -18,16 +21,72 @@ template <typename EntityId, typename T> using Set = internal::SparseSet<EntityI
  */
 template <typename EntityId> using Manager = internal::EntityComponentManager<EntityId>;
 
+/**
+ * @brief An alternative to the manager which stores components in archetype tables, trading slower adds and
+ * removes for faster iteration over many component types at once.
+ */
+template <typename EntityId> using ArchetypeManager = internal::ArchetypeManager<EntityId>;
+
+/**
+ * @brief A grouping of the archetype tables which have all of the specified components.
+ */
+template <typename EntityId, typename... Ts> using ArchetypeGroup = internal::ArchetypeGrouping<EntityId, Ts...>;
+
 /**
  * @brief A grouping of entities which have all of the specified components.
  */
 template <typename EntityId, typename T> using Group = internal::Grouping<EntityId, T>;
 
+/**
+ * @brief A group which keeps the dense order of its component sets in sync, for lockstep iteration.
+ */
+template <typename EntityId, typename... Ts> using OwningGroup = internal::OwningGrouping<EntityId, Ts...>;
+
+/**
+ * @brief A persistent grouping of entities which is updated incrementally as components are added and removed.
+ */
+template <typename EntityId, typename... Ts> using Query = internal::CachedQuery<EntityId, Ts...>;
+
 /**
  * @brief A wrapper for a component of the specific type.  The wrapper controls how the component is arranged
  * and provides access methods for the component data.
  */
 template <typename T> using Components = internal::ComponentsWrapper<T>;
+
+/**
+ * @brief A read-only view of components, returned when filtering, narrowing, or sorting a const wrapper.
+ */
+template <typename T> using ReadOnlyComponents = internal::ReadOnlyComponentsWrapper<T>;
+
+/**
+ * @brief Ids of the entities which gained, lost, or had overwritten a component of an observed type.
+ */
+template <typename EntityId> using ComponentEvents = internal::ComponentEvents<EntityId>;
+
+/**
+ * @brief Records structural changes, such as adding and removing components, to apply at a later sync point.
+ */
+template <typename EntityId> using CommandBuffer = internal::CommandBuffer<EntityId>;
+
+/**
+ * @brief Worker threads which parallel loops over sets and groups are split between.
+ */
+using ThreadPool = internal::ThreadPool;
+
+/**
+ * @brief Runs registered systems each frame, in parallel where their declared component access allows.
+ */
+template <typename EntityId> using Scheduler = internal::Scheduler<EntityId>;
+
+/**
+ * @brief Declares read access to the component types when registering a system.
+ */
+template <typename... Ts> using Read = internal::Read<Ts...>;
+
+/**
+ * @brief Declares write access to the component types when registering a system.
+ */
+template <typename... Ts> using Write = internal::Write<Ts...>;
 } // namespace ECS
 
 #undef ECS_LOG_WARNING
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "components.hpp"
+#include "core.hpp"
+#include "macros.hpp"
+#include "utilities.hpp"
+
+namespace ECS
+{
+namespace internal
+{
+
+/**
+ * @brief A grouping of the archetype tables which have all of the specified components
+ *
+ * Iteration walks each matching table's rows in order, so the components of every type are read contiguously
+ * with no per-entity lookups.  Rows whose component was removed through a wrapper, but which have not moved
+ * table since, are skipped.
+ */
+template <typename EntityId, typename... Ts> class ArchetypeGrouping
+{
+  public:
+    struct Match
+    {
+        const std::vector<EntityId> *ids{};
+        std::tuple<ComponentStorage<Ts> *...> storages{};
+    };
+
+    ArchetypeGrouping() = default;
+    explicit ArchetypeGrouping(std::vector<Match> _matches) : m_matches(std::move(_matches))
+    {
+    }
+
+    /**
+     * @brief Iterate over the group and pass the entity components into the function
+     *
+     * The function argument can optionally return a bool to determine the loop-breaking behavior.
+     * A false return value is a break.
+     *
+     * @param Function which accepts the entity id and component types
+     */
+    template <typename Func> void each(Func &&fn)
+    {
+        constexpr bool shouldBreak = Utilities::ReturnsBool<Func, EntityId, ComponentsWrapper<Ts> &...>;
+
+        for (auto &match : m_matches)
+        {
+            for (size_t row = 0; row < match.ids->size(); ++row)
+            {
+                if ((std::get<ComponentStorage<Ts> *>(match.storages)->isEmpty(row) || ...))
+                    continue;
+
+                auto comps = std::make_tuple(
+                    ComponentsWrapper<Ts>(std::get<ComponentStorage<Ts> *>(match.storages), row)...);
+                auto &id = (*match.ids)[row];
+                if constexpr (shouldBreak)
+                {
+                    if (!std::apply([&](auto &...components) { return fn(id, components...); }, comps))
+                        return;
+                }
+                else
+                    std::apply([&](auto &...components) { fn(id, components...); }, comps);
+            }
+        }
+    }
+
+    /**
+     * @brief Read-only iteration over the group, which passes the entity components as const wrappers
+     *
+     * The function argument can optionally return a bool to determine the loop-breaking behavior.
+     * A false return value is a break.
+     *
+     * @param Function which accepts the entity id and const component types
+     */
+    template <typename Func> void inspectEach(Func &&fn) const
+    {
+        constexpr bool shouldBreak = Utilities::ReturnsBool<Func, EntityId, const ComponentsWrapper<Ts> &...>;
+
+        for (const auto &match : m_matches)
+        {
+            for (size_t row = 0; row < match.ids->size(); ++row)
+            {
+                if ((std::get<ComponentStorage<Ts> *>(match.storages)->isEmpty(row) || ...))
+                    continue;
+
+                const auto comps = std::make_tuple(
+                    ComponentsWrapper<Ts>(std::get<ComponentStorage<Ts> *>(match.storages), row)...);
+                const auto &id = (*match.ids)[row];
+                if constexpr (shouldBreak)
+                {
+                    if (!std::apply([&](const auto &...components) { return fn(id, components...); }, comps))
+                        return;
+                }
+                else
+                    std::apply([&](const auto &...components) { fn(id, components...); }, comps);
+            }
+        }
+    }
+
+    /**
+     * @brief Get the number of entities in the matching tables
+     *
+     * @return size_t
+     */
+    [[nodiscard]] size_t size() const
+    {
+        size_t size{};
+        for (const auto &match : m_matches)
+            size += match.ids->size();
+
+        return size;
+    }
+
+    /**
+     * @brief Evaluate by number of entities
+     *
+     * @return size_t
+     */
+    [[nodiscard]] explicit operator bool() const
+    {
+        return !!size();
+    }
+
+    /**
+     * @brief Get a copy of the entity ids, in iteration order
+     *
+     * @return std::vector<EntityId>
+     */
+    [[nodiscard]] std::vector<EntityId> getIds() const
+    {
+        std::vector<EntityId> ids;
+        ids.reserve(size());
+        for (const auto &match : m_matches)
+            ids.insert(ids.end(), match.ids->begin(), match.ids->end());
+
+        return ids;
+    }
+
+  private:
+    std::vector<Match> m_matches{};
+};
+} // namespace internal
+}; // namespace ECS
@@ -0,0 +1,689 @@
+#pragma once
+
+#include "archetype_grouping.hpp"
+#include "archetype_table.hpp"
+#include "components.hpp"
+#include "core.hpp"
+#include "entity.hpp"
+#include "macros.hpp"
+#include "utilities.hpp"
+
+namespace ECS
+{
+namespace internal
+{
+
+/**
+ * @brief Entity component manager which stores components in archetype tables instead of sparse sets
+ *
+ * Every entity with the same set of component types shares a table, with a column per type.  Groups are a
+ * list of the matching tables, so iterating many types at once is a linear walk over each column, with no
+ * per-entity lookups.  In exchange, adding or removing a component type moves all of the entity's components
+ * to another table, which makes structural changes more expensive than with sparse sets.
+ *
+ * The manager shares the entity id, add, get, group, and remove API of the sparse set manager, so either
+ * backend can be picked per manager for the workload at hand.  Tags which rely on sparse sets, such as Unique
+ * and Required, as well as transformations, owning groups, and cached queries, are only available on the
+ * sparse set manager.
+ */
+template <typename EntityId> class ArchetypeManager
+{
+  private:
+    using Table = ArchetypeTable<EntityId>;
+    using Entity = EntityTraits<EntityId>;
+
+    static constexpr size_t npos = Table::npos;
+
+  public:
+    explicit ArchetypeManager(EntityId reservedEntities = 10) : m_entityIds(reservedEntities)
+    {
+        // Entities without components are not stored, so the empty table is only the root of the edges
+        m_tables.push_back(
+            std::make_unique<Table>(std::vector<size_t>{}, std::vector<std::unique_ptr<ErasedColumn>>{}));
+        m_tableIndexes[std::vector<size_t>{}] = 0;
+    }
+
+    /**
+     * @brief Creates a new unique entity id
+     *
+     * @return New entity id
+     */
+    [[nodiscard]] EntityId createEntity()
+    {
+        return m_entityIds.create();
+    }
+
+    /**
+     * @brief Creates a new entity with a component of each of the types
+     *
+     * The table of the types is looked up once, and the entity is placed in it directly, rather than moving
+     * through a table for every type added.
+     *
+     * @tparam Ts - Component types
+     *
+     * @param Tuples of the constructor arguments of each component, in the order of the types.  Omitting them
+     * default constructs every component
+     *
+     * @return New entity id
+     */
+    template <typename T, typename... Ts, typename... ArgTuples>
+    EntityId createEntity(ArgTuples &&...argTuples)
+    {
+        static_assert(sizeof...(ArgTuples) == 0 || sizeof...(ArgTuples) == sizeof...(Ts) + 1,
+                      "Pass constructor arguments for every component type, or for none of them");
+
+        auto tableIndex = getTable<T, Ts...>();
+        auto eId = m_entityIds.create();
+        appendRow(tableIndex, eId);
+        emplaceColumns<T, Ts...>(*m_tables[tableIndex], 1, argTuples...);
+
+        return eId;
+    }
+
+    /**
+     * @brief Creates entities which each have an identical component of each of the types
+     *
+     * @tparam Ts - Component types
+     *
+     * @param Number of entities
+     * @param Tuples of the constructor arguments of each component, in the order of the types.  Omitting them
+     * default constructs every component
+     *
+     * @return Ids of the new entities
+     */
+    template <typename T, typename... Ts, typename... ArgTuples>
+    std::vector<EntityId> createEntities(size_t count, ArgTuples &&...argTuples)
+    {
+        static_assert(sizeof...(ArgTuples) == 0 || sizeof...(ArgTuples) == sizeof...(Ts) + 1,
+                      "Pass constructor arguments for every component type, or for none of them");
+
+        auto tableIndex = getTable<T, Ts...>();
+        auto &table = *m_tables[tableIndex];
+        table.ids.reserve(table.ids.size() + count);
+        for (auto &column : table.columns)
+            column->reserve(table.ids.size() + count);
+
+        std::vector<EntityId> ids(count);
+        for (auto &id : ids)
+        {
+            id = m_entityIds.create();
+            appendRow(tableIndex, id);
+        }
+
+        emplaceColumns<T, Ts...>(table, count, argTuples...);
+        return ids;
+    }
+
+    /**
+     * @brief Creates entities which each have a copy of every component of the source entity
+     *
+     * The copies are appended to the source's table, one column at a time.
+     *
+     * @param Entity id to copy the components of
+     * @param Number of entities
+     *
+     * @return Ids of the new entities
+     */
+    std::vector<EntityId> clone(EntityId source, size_t count)
+    {
+        std::vector<EntityId> ids(count);
+        for (auto &id : ids)
+            id = m_entityIds.create();
+
+        auto [tableIndex, row] = locate(source);
+        if (tableIndex == npos || ids.empty())
+            return ids;
+
+        auto &table = *m_tables[tableIndex];
+        table.ids.reserve(table.ids.size() + count);
+        for (auto &column : table.columns)
+            column->appendCopies(row, count);
+
+        for (const auto &id : ids)
+            appendRow(tableIndex, id);
+
+        return ids;
+    }
+
+    /**
+     * @brief Creates an entity with a copy of every component of the source entity
+     *
+     * @param Entity id to copy the components of
+     *
+     * @return New entity id
+     */
+    EntityId clone(EntityId source)
+    {
+        return clone(source, 1).front();
+    }
+
+    /**
+     * @brief Remove every component of the entity and recycle its id
+     *
+     * @param Entity id
+     */
+    void destroyEntity(EntityId eId)
+    {
+        remove(eId);
+        m_entityIds.destroy(eId);
+    }
+
+    /**
+     * @brief Check whether the id was created by the manager and has not since been destroyed
+     *
+     * @param Entity id
+     */
+    [[nodiscard]] bool isAlive(EntityId eId) const
+    {
+        return m_entityIds.isAlive(eId);
+    }
+
+    /**
+     * @brief Constructs and add a component to the entity, moving it to the table of its new set of types
+     *
+     * Raw ids which were not created by the manager must fit in the index bits of the id, eg. below 2^24 for
+     * a 32-bit unsigned id.  See EntityTraits.
+     *
+     * @tparam T - Component type
+     *
+     * @param Entity Id
+     * @param Variable arguments for the component constructor
+     */
+    template <typename T, typename... Args> void add(EntityId eId, Args... args)
+    {
+        static_assert(!Utilities::isUnique<T>(), "Unique components require the sparse set manager");
+
+        if (eId == 0)
+            return;
+
+        auto componentId = Utilities::getTypeId<T>();
+        auto [tableIndex, row] = locate(eId);
+
+        if (tableIndex != npos)
+        {
+            auto column = m_tables[tableIndex]->findColumn(componentId);
+            if (column != npos)
+            {
+                if (!m_tables[tableIndex]->template getStorage<T>(column)->emplaceInto(row, args...))
+                    ECS_LOG_WARNING(eId, "Already contains a NoStack-tagged ", Utilities::getTypeName<T>(),
+                                    "Add failed!");
+                return;
+            }
+        }
+        else if (isOccupied(eId))
+        {
+            ECS_LOG_WARNING(eId, "is a stale entity id for", Utilities::getTypeName<T>(), "Add failed!");
+            return;
+        }
+        else
+            tableIndex = 0;
+
+        auto targetIndex = getAddTarget<T>(tableIndex, componentId);
+        row = move(eId, tableIndex, row, targetIndex);
+
+        auto &target = *m_tables[targetIndex];
+        target.template getStorage<T>(target.findColumn(componentId))->emplace(args...);
+    }
+
+    /**
+     * @brief Overwrites a components instance for the specified entity
+     *
+     * @tparam T - Component type
+     *
+     * @param Entity Id
+     * @param Variable arguments for the component constructor
+     */
+    template <typename T, typename... Args> void overwrite(EntityId eId, Args... args)
+    {
+        if (eId == 0)
+            return;
+
+        auto components = getComponents<T>(eId);
+        if (!components)
+        {
+            ECS_LOG_WARNING(eId, "does not contain", Utilities::getTypeName<T>(), "Overwrite failed!");
+            return;
+        }
+
+        components.m_storage->overwrite(components.m_index, T(args...));
+    }
+
+    /**
+     * @brief Get specified components for the entity
+     *
+     * Components which the entity does not have are returned as an empty wrapper.  The wrappers are only valid
+     * until the entity's set of component types next changes.
+     *
+     * @tparam Ts - Component types
+     *
+     * @param Entity Id
+     *
+     * @return Entity component views
+     */
+    template <typename... Ts> [[nodiscard]] std::tuple<ComponentsWrapper<Ts>...> get(EntityId eId)
+    {
+        return {getComponents<Ts>(eId)...};
+    }
+
+    /**
+     * @brief Get a grouping of the tables which have all of the specified components
+     *
+     * The matching tables are cached per grouping type, and only tables created since the last call are
+     * checked.
+     *
+     * @tparam Ts - Component types
+     *
+     * @return Archetype grouping
+     */
+    template <typename... Ts> [[nodiscard]] ArchetypeGrouping<EntityId, Ts...> getGroup()
+    {
+        using Grouping = ArchetypeGrouping<EntityId, Ts...>;
+        static_assert(sizeof...(Ts) > 0, "At least one component type is required");
+
+        auto &matches = getMatches<Grouping, Ts...>();
+
+        std::vector<typename Grouping::Match> groupMatches;
+        groupMatches.reserve(matches.tables.size());
+        for (const auto &tableIndex : matches.tables)
+        {
+            auto &table = *m_tables[tableIndex];
+            if (table.ids.empty())
+                continue;
+
+            groupMatches.push_back({&table.ids, {table.template getStorage<Ts>(
+                                                    table.findColumn(Utilities::getTypeId<Ts>()))...}});
+        }
+
+        return Grouping(std::move(groupMatches));
+    }
+
+    /**
+     * @brief Get the ids of the entities which have all of the specified components
+     *
+     * @tparam Ts - Component types
+     *
+     * @return Entity ids
+     */
+    template <typename... Ts> [[nodiscard]] std::vector<EntityId> getEntityIds()
+    {
+        return getGroup<Ts...>().getIds();
+    }
+
+    /**
+     * @brief Check whether or not the entity has all of the component types
+     *
+     * @tparam Ts - Component types
+     *
+     * @param Entity Id
+     *
+     * @return Bool - true if the entity has every component type
+     */
+    template <typename... Ts> [[nodiscard]] bool contains(EntityId eId)
+    {
+        static_assert(sizeof...(Ts) > 0, "At least one component type is required");
+
+        return (!!getComponents<Ts>(eId) && ...);
+    }
+
+    /**
+     * @brief Remove the component types from the entity, or every component if no types are specified
+     *
+     * @tparam Ts - Component types
+     *
+     * @param Entity Id
+     */
+    template <typename... Ts> void remove(EntityId eId)
+    {
+        auto [tableIndex, row] = locate(eId);
+        if (tableIndex == npos)
+            return;
+
+        if constexpr (sizeof...(Ts) == 0)
+        {
+            removeRow(tableIndex, row);
+            m_locations[Entity::getIndex(eId)] = {};
+        }
+        else
+            (removeComponent<Ts>(eId), ...);
+    }
+
+    /**
+     * @brief Remove specified ids from EVERY table
+     *
+     * @param Entity ids
+     */
+    void remove(const std::vector<EntityId> &ids)
+    {
+        for (const auto &id : ids)
+            remove(id);
+    }
+
+    /**
+     * @brief Get the current tick of the frame counter, which components changed now are stamped with
+     *
+     * @return Tick
+     */
+    [[nodiscard]] ChangeTick getTick() const
+    {
+        return m_tick;
+    }
+
+    /**
+     * @brief Move the frame counter on to the next tick
+     *
+     * @return The new tick
+     */
+    ChangeTick advanceTick()
+    {
+        return ++m_tick;
+    }
+
+    /**
+     * @brief Get the number of tables, including the empty root table
+     */
+    [[nodiscard]] size_t getTableCount() const
+    {
+        return m_tables.size();
+    }
+
+    ArchetypeManager(const ArchetypeManager &) = delete;
+    ArchetypeManager &operator=(const ArchetypeManager &) = delete;
+
+  private:
+    struct Location
+    {
+        uint32_t table{std::numeric_limits<uint32_t>::max()};
+        uint32_t row{};
+    };
+
+    struct Matches
+    {
+        std::vector<size_t> tables{};
+        size_t checkedTables{};
+    };
+
+    /**
+     * @brief Get the entity's table and row
+     *
+     * @return Table index and row, with npos as the table index if the entity has no components
+     */
+    [[nodiscard]] std::pair<size_t, size_t> locate(EntityId eId) const
+    {
+        auto index = Entity::getIndex(eId);
+        if (index >= m_locations.size())
+            return {npos, 0};
+
+        const auto &location = m_locations[index];
+        if (location.table == std::numeric_limits<uint32_t>::max())
+            return {npos, 0};
+
+        // The index may belong to a newer or older version of the id
+        if (m_tables[location.table]->ids[location.row] != eId)
+            return {npos, 0};
+
+        return {location.table, location.row};
+    }
+
+    /**
+     * @brief Check whether the entity's index is stored for a different version of the id
+     */
+    [[nodiscard]] bool isOccupied(EntityId eId) const
+    {
+        auto index = Entity::getIndex(eId);
+        if (index >= m_locations.size())
+            return false;
+
+        const auto &location = m_locations[index];
+        if (location.table == std::numeric_limits<uint32_t>::max())
+            return false;
+
+        return m_tables[location.table]->ids[location.row] != eId;
+    }
+
+    void setLocation(EntityId eId, size_t tableIndex, size_t row)
+    {
+        auto index = Entity::getIndex(eId);
+        if (index >= m_locations.size())
+            m_locations.resize(std::max<size_t>(index + 1, m_locations.size() * 2));
+
+        m_locations[index] = {static_cast<uint32_t>(tableIndex), static_cast<uint32_t>(row)};
+    }
+
+    template <typename T> ComponentsWrapper<T> getComponents(EntityId eId)
+    {
+        auto [tableIndex, row] = locate(eId);
+        if (tableIndex == npos)
+            return ComponentsWrapper<T>();
+
+        auto &table = *m_tables[tableIndex];
+        auto column = table.findColumn(Utilities::getTypeId<T>());
+        if (column == npos)
+            return ComponentsWrapper<T>();
+
+        return ComponentsWrapper<T>(table.template getStorage<T>(column), row);
+    }
+
+    template <typename T> void removeComponent(EntityId eId)
+    {
+        auto [tableIndex, row] = locate(eId);
+        if (tableIndex == npos)
+            return;
+
+        auto componentId = Utilities::getTypeId<T>();
+        if (m_tables[tableIndex]->findColumn(componentId) == npos)
+            return;
+
+        auto targetIndex = getRemoveTarget(tableIndex, componentId);
+        if (targetIndex == 0)
+        {
+            removeRow(tableIndex, row);
+            m_locations[Entity::getIndex(eId)] = {};
+            return;
+        }
+
+        move(eId, tableIndex, row, targetIndex);
+    }
+
+    /**
+     * @brief Move the entity's row to the target table, dropping the columns which the target does not have
+     *
+     * Columns which the source does not have are left for the caller to append to.
+     *
+     * @return Row of the entity in the target table
+     */
+    size_t move(EntityId eId, size_t sourceIndex, size_t row, size_t targetIndex)
+    {
+        auto &target = *m_tables[targetIndex];
+        auto targetRow = target.ids.size();
+        target.ids.push_back(eId);
+
+        if (sourceIndex != 0)
+        {
+            auto &source = *m_tables[sourceIndex];
+            for (size_t i = 0; i < source.signature.size(); ++i)
+            {
+                auto column = target.findColumn(source.signature[i]);
+                if (column != npos)
+                    target.columns[column]->appendFrom(*source.columns[i], row);
+            }
+
+            removeRow(sourceIndex, row);
+        }
+
+        setLocation(eId, targetIndex, targetRow);
+        return targetRow;
+    }
+
+    void removeRow(size_t tableIndex, size_t row)
+    {
+        if (auto movedId = m_tables[tableIndex]->swapRemove(row))
+            setLocation(movedId, tableIndex, row);
+    }
+
+    /**
+     * @brief Get the table of exactly the component types, creating it if needed
+     *
+     * Tables are cached by the list of types, so the signature is only sorted and looked up the first time.
+     */
+    template <typename... Ts> size_t getTable()
+    {
+        static_assert(Utilities::areDistinct<Ts...>(), "Component types of a new entity must be distinct");
+
+        auto listId = Utilities::getTypeId<std::tuple<Ts...>, Utilities::TypeIdFamily::Grouping>();
+        if (listId < m_typeListTables.size() && m_typeListTables[listId] != npos)
+            return m_typeListTables[listId];
+
+        std::vector<size_t> signature{Utilities::getTypeId<Ts>()...};
+        std::sort(signature.begin(), signature.end());
+
+        auto tableIndex = findOrCreateTable(signature, [&]() {
+            std::vector<std::unique_ptr<ErasedColumn>> columns(signature.size());
+            ((columns[static_cast<size_t>(std::lower_bound(signature.begin(), signature.end(),
+                                                           Utilities::getTypeId<Ts>()) -
+                                          signature.begin())] = std::make_unique<Column<Ts>>()),
+             ...);
+
+            return columns;
+        });
+
+        if (listId >= m_typeListTables.size())
+            m_typeListTables.resize(listId + 1, npos);
+
+        m_typeListTables[listId] = tableIndex;
+        return tableIndex;
+    }
+
+    void appendRow(size_t tableIndex, EntityId eId)
+    {
+        auto &table = *m_tables[tableIndex];
+        setLocation(eId, tableIndex, table.ids.size());
+        table.ids.push_back(eId);
+    }
+
+    /**
+     * @brief Append the number of components to the column of each type, constructed from the type's tuple
+     */
+    template <typename... Ts, typename... ArgTuples>
+    void emplaceColumns(Table &table, size_t count, const ArgTuples &...argTuples)
+    {
+        auto emplace = [&]<typename U>(std::type_identity<U>, const auto &argTuple) {
+            auto &storage = *table.template getStorage<U>(table.findColumn(Utilities::getTypeId<U>()));
+            for (size_t i = 0; i < count; ++i)
+                storage.emplace(std::make_from_tuple<U>(argTuple));
+        };
+
+        if constexpr (sizeof...(ArgTuples) == 0)
+            (emplace(std::type_identity<Ts>{}, std::tuple<>{}), ...);
+        else
+            (emplace(std::type_identity<Ts>{}, argTuples), ...);
+    }
+
+    template <typename T> size_t getAddTarget(size_t tableIndex, size_t componentId)
+    {
+        auto targetIndex = m_tables[tableIndex]->getEdge(m_tables[tableIndex]->addEdges, componentId);
+        if (targetIndex != npos)
+            return targetIndex;
+
+        auto signature = m_tables[tableIndex]->signature;
+        signature.insert(std::lower_bound(signature.begin(), signature.end(), componentId), componentId);
+
+        targetIndex = findOrCreateTable(signature, [&]() {
+            auto &source = *m_tables[tableIndex];
+
+            std::vector<std::unique_ptr<ErasedColumn>> columns;
+            for (size_t i = 0; i < signature.size(); ++i)
+            {
+                if (signature[i] == componentId)
+                    columns.push_back(std::make_unique<Column<T>>());
+                else
+                    columns.push_back(source.columns[source.findColumn(signature[i])]->cloneEmpty());
+            }
+
+            return columns;
+        });
+
+        m_tables[tableIndex]->setEdge(m_tables[tableIndex]->addEdges, componentId, targetIndex);
+        m_tables[targetIndex]->setEdge(m_tables[targetIndex]->removeEdges, componentId, tableIndex);
+        return targetIndex;
+    }
+
+    size_t getRemoveTarget(size_t tableIndex, size_t componentId)
+    {
+        auto targetIndex = m_tables[tableIndex]->getEdge(m_tables[tableIndex]->removeEdges, componentId);
+        if (targetIndex != npos)
+            return targetIndex;
+
+        auto signature = m_tables[tableIndex]->signature;
+        signature.erase(std::find(signature.begin(), signature.end(), componentId));
+
+        targetIndex = findOrCreateTable(signature, [&]() {
+            auto &source = *m_tables[tableIndex];
+
+            std::vector<std::unique_ptr<ErasedColumn>> columns;
+            for (const auto &id : signature)
+                columns.push_back(source.columns[source.findColumn(id)]->cloneEmpty());
+
+            return columns;
+        });
+
+        m_tables[tableIndex]->setEdge(m_tables[tableIndex]->removeEdges, componentId, targetIndex);
+        m_tables[targetIndex]->setEdge(m_tables[targetIndex]->addEdges, componentId, tableIndex);
+        return targetIndex;
+    }
+
+    template <typename Func>
+    size_t findOrCreateTable(const std::vector<size_t> &signature, Func &&createColumns)
+    {
+        auto it = m_tableIndexes.find(signature);
+        if (it != m_tableIndexes.end())
+            return it->second;
+
+        auto tableIndex = m_tables.size();
+        m_tables.push_back(std::make_unique<Table>(signature, createColumns()));
+        for (auto &column : m_tables.back()->columns)
+            column->setTickSource(&m_tick);
+
+        m_tableIndexes[signature] = tableIndex;
+        return tableIndex;
+    }
+
+    /**
+     * @brief Get the cached tables which have every component type, checking any tables created since
+     */
+    template <typename Grouping, typename... Ts> Matches &getMatches()
+    {
+        auto groupId = Utilities::getTypeId<Grouping, Utilities::TypeIdFamily::Grouping>();
+        if (groupId >= m_matches.size())
+            m_matches.resize(groupId + 1);
+
+        auto &matches = m_matches[groupId];
+        for (; matches.checkedTables < m_tables.size(); ++matches.checkedTables)
+        {
+            const auto &table = *m_tables[matches.checkedTables];
+            if (((table.findColumn(Utilities::getTypeId<Ts>()) != npos) && ...))
+                matches.tables.push_back(matches.checkedTables);
+        }
+
+        return matches;
+    }
+
+    EntityIdPool<EntityId> m_entityIds;
+
+    // Frame counter which components are stamped with when they change
+    ChangeTick m_tick{1};
+
+    // Tables are never destroyed, so their indexes and column storage stay valid
+    std::vector<std::unique_ptr<Table>> m_tables{};
+    std::map<std::vector<size_t>, size_t> m_tableIndexes{};
+
+    // Table and row of each entity by index
+    std::vector<Location> m_locations{};
+
+    // Table of each list of types which entities were created with, by the type id of the list
+    std::vector<size_t> m_typeListTables{};
+
+    // Matching tables of each grouping type, by the type id of the grouping
+    std::vector<Matches> m_matches{};
+};
+}; // namespace internal
+}; // namespace ECS
@@ -0,0 +1,166 @@
+#pragma once
+
+#include "component_storage.hpp"
+#include "core.hpp"
+#include "macros.hpp"
+#include "utilities.hpp"
+
+namespace ECS
+{
+namespace internal
+{
+
+/**
+ * @brief Type erased column of an archetype table, so tables can move rows between each other
+ */
+class ErasedColumn
+{
+  public:
+    virtual ~ErasedColumn() = default;
+
+    /**
+     * @brief Create an empty column of the same component type
+     */
+    [[nodiscard]] virtual std::unique_ptr<ErasedColumn> cloneEmpty() const = 0;
+
+    /**
+     * @brief Append a row holding the components moved out of the same type's column of another table
+     */
+    virtual void appendFrom(ErasedColumn &source, size_t row) = 0;
+
+    /**
+     * @brief Append the number of rows, each holding a copy of the row's components
+     */
+    virtual void appendCopies(size_t row, size_t count) = 0;
+
+    virtual void swapRemove(size_t row) = 0;
+
+    virtual void reserve(size_t size) = 0;
+
+    virtual void setTickSource(const ChangeTick *tickSource) = 0;
+};
+
+template <typename T> class Column : public ErasedColumn
+{
+  public:
+    [[nodiscard]] std::unique_ptr<ErasedColumn> cloneEmpty() const override
+    {
+        return std::make_unique<Column<T>>();
+    }
+
+    void appendFrom(ErasedColumn &source, size_t row) override
+    {
+        storage.appendFrom(static_cast<Column<T> &>(source).storage, row);
+    }
+
+    void appendCopies(size_t row, size_t count) override
+    {
+        storage.appendCopies(row, count);
+    }
+
+    void swapRemove(size_t row) override
+    {
+        storage.swapRemove(row);
+    }
+
+    void reserve(size_t size) override
+    {
+        storage.reserve(size);
+    }
+
+    void setTickSource(const ChangeTick *tickSource) override
+    {
+        storage.setTickSource(tickSource);
+    }
+
+    ComponentStorage<T> storage{};
+};
+
+/**
+ * @brief Table of every entity which has exactly the same set of component types
+ *
+ * Each component type is a column, and each entity is a row at the same index in every column.  Adding or
+ * removing a component type moves the entity's row to the table of the new set of types, which is looked up
+ * once and then cached as an edge of the table.
+ */
+template <typename EntityId> class ArchetypeTable
+{
+  public:
+    static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+    /**
+     * @param Sorted component type ids
+     * @param Columns in the same order as the ids
+     */
+    ArchetypeTable(std::vector<size_t> _signature, std::vector<std::unique_ptr<ErasedColumn>> _columns)
+        : signature(std::move(_signature)), columns(std::move(_columns))
+    {
+    }
+
+    /**
+     * @brief Get the position of the component type's column
+     *
+     * @return Column index, or npos if the table does not have the type
+     */
+    [[nodiscard]] size_t findColumn(size_t componentId) const
+    {
+        auto it = std::lower_bound(signature.begin(), signature.end(), componentId);
+        if (it == signature.end() || *it != componentId)
+            return npos;
+
+        return static_cast<size_t>(it - signature.begin());
+    }
+
+    template <typename T> [[nodiscard]] ComponentStorage<T> *getStorage(size_t column)
+    {
+        return &static_cast<Column<T> &>(*columns[column]).storage;
+    }
+
+    /**
+     * @brief Remove the row by moving the last row into it
+     *
+     * @return Id of the entity which now occupies the row, or 0 if the last row was removed
+     */
+    EntityId swapRemove(size_t row)
+    {
+        for (auto &column : columns)
+            column->swapRemove(row);
+
+        auto lastRow = ids.size() - 1;
+        EntityId movedId{0};
+        if (row != lastRow)
+        {
+            ids[row] = ids[lastRow];
+            movedId = ids[row];
+        }
+
+        ids.pop_back();
+        return movedId;
+    }
+
+    /**
+     * @brief Get the cached table reached by adding or removing the component type, or npos if not yet known
+     */
+    [[nodiscard]] size_t getEdge(const std::vector<size_t> &edges, size_t componentId) const
+    {
+        return componentId < edges.size() ? edges[componentId] : npos;
+    }
+
+    void setEdge(std::vector<size_t> &edges, size_t componentId, size_t tableIndex)
+    {
+        if (componentId >= edges.size())
+            edges.resize(componentId + 1, npos);
+
+        edges[componentId] = tableIndex;
+    }
+
+    std::vector<size_t> signature;
+    std::vector<EntityId> ids{};
+    std::vector<std::unique_ptr<ErasedColumn>> columns;
+
+    // Tables reached by adding or removing a component type, indexed by the type id
+    std::vector<size_t> addEdges{};
+    std::vector<size_t> removeEdges{};
+};
+}; // namespace internal
+}; // namespace ECS
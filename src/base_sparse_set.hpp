@@ -1,6 +1,31 @@
 #pragma once
 
+#include "component_events.hpp"
 #include "core.hpp"
+#include "signature.hpp"
+
+namespace ECS
+{
+namespace internal
+{
+
+/**
+ * @brief Notified by the sets it observes whenever ids are inserted into or erased from them
+ */
+template <typename Id> class SetObserver
+{
+  public:
+    virtual ~SetObserver() = default;
+
+    // Called after the id has been inserted
+    virtual void onInsert(Id id) = 0;
+
+    // Called before the id is erased, while it is still stored
+    virtual void onErase(Id id) = 0;
+
+    // Called after every id has been cleared from one of the observed sets
+    virtual void onClear() = 0;
+};
 
 template <typename Id, typename T> class BaseSparseSet
 {
@@ -13,8 +38,60 @@ template <typename Id, typename T> class BaseSparseSet
     virtual ~BaseSparseSet() = default;
 
     virtual void erase(Id id) = 0;
+    virtual void clear() = 0;
+
+    // Add a copy of the source id's components to each of the ids, which must not already be stored
+    virtual void clone(Id source, std::span<const Id> ids) = 0;
+
     virtual size_t size() const = 0;
 
+    /**
+     * @brief Get the type id of the component stored in the set
+     */
+    [[nodiscard]] size_t getComponentId() const
+    {
+        return m_componentId;
+    }
+
+    /**
+     * @brief Check whether an owning group, a query, or an event queue depends on the set
+     */
+    [[nodiscard]] bool isObserved() const
+    {
+        return m_owner || !m_observers.empty() || m_events;
+    }
+
+    /**
+     * @brief Start recording add, remove, and overwrite events, if not already recording
+     *
+     * @return Queue of the events recorded since the last drain
+     */
+    ComponentEvents<Id> &recordEvents()
+    {
+        if (!m_events)
+            m_events = std::make_unique<ComponentEvents<Id>>();
+
+        return *m_events;
+    }
+
+    /**
+     * @brief Get the recorded events, or null if the set does not record events
+     */
+    [[nodiscard]] ComponentEvents<Id> *getEvents()
+    {
+        return m_events.get();
+    }
+
+    void addObserver(SetObserver<Id> *observer)
+    {
+        m_observers.push_back(observer);
+    }
+
+    void removeObserver(SetObserver<Id> *observer)
+    {
+        m_observers.erase(std::remove(m_observers.begin(), m_observers.end(), observer), m_observers.end());
+    }
+
     template <typename Func> void each(Func fn)
     {
     }
@@ -27,4 +104,55 @@ template <typename Id, typename T> class BaseSparseSet
     virtual void prune()
     {
     }
+
+  protected:
+    void notifyInsert(Id id)
+    {
+        if (m_events)
+            m_events->added.push_back(id);
+
+        if (m_owner)
+            m_owner->onInsert(id);
+
+        for (auto &observer : m_observers)
+            observer->onInsert(id);
+    }
+
+    void notifyErase(Id id)
+    {
+        if (m_events)
+            m_events->removed.push_back(id);
+
+        if (m_owner)
+            m_owner->onErase(id);
+
+        for (auto &observer : m_observers)
+            observer->onErase(id);
+    }
+
+    void notifyClear()
+    {
+        if (m_owner)
+            m_owner->onClear();
+
+        for (auto &observer : m_observers)
+            observer->onClear();
+    }
+
+    // Recorded when the set is registered so that downcasts can be verified without RTTI
+    size_t m_componentId{};
+
+    // Owned by the manager.  Kept in sync with the ids stored in the set, when set
+    EntitySignatures<Id> *m_signatures{nullptr};
+
+    // The owning group which partitions the set, if any
+    SetObserver<Id> *m_owner{nullptr};
+
+    // Queries which are kept up to date with the ids in the set
+    std::vector<SetObserver<Id> *> m_observers{};
+
+    // Events waiting to be drained, when the component type is observed
+    std::unique_ptr<ComponentEvents<Id>> m_events{};
 };
+}; // namespace internal
+}; // namespace ECS
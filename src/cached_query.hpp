@@ -0,0 +1,227 @@
+#pragma once
+
+#include "base_sparse_set.hpp"
+#include "core.hpp"
+#include "entity.hpp"
+#include "macros.hpp"
+#include "paged_sparse_array.hpp"
+#include "utilities.hpp"
+
+namespace ECS
+{
+namespace internal
+{
+
+/**
+ * @brief A persistent grouping of entities which have all of the specified components
+ *
+ * The query observes its component sets and records which entities were inserted into or erased from them.
+ * Those entities are re-checked the next time the query is used, so using it costs the number of changes since
+ * the last use rather than the size of the sets.  Matching ids are kept in a vector which is reused from one use
+ * to the next.
+ */
+template <typename EntityId, typename... Ts> class CachedQuery : public SetObserver<EntityId>
+{
+  public:
+    explicit CachedQuery(Ts &..._sets) : m_sets(&_sets...)
+    {
+        (_sets.addObserver(this), ...);
+        rebuild();
+    }
+
+    ~CachedQuery() override
+    {
+        (std::get<Ts *>(m_sets)->removeObserver(this), ...);
+    }
+
+    /**
+     * @brief Iterate over the matching entities and pass their components into the function
+     *
+     * The function argument can optionally return a bool to determine the loop-breaking behavior.
+     * A false return value is a break.
+     *
+     * Entities whose components have all been removed, but not yet pruned, are skipped.
+     *
+     * @param Function which accepts the entity id and component types
+     */
+    template <typename Func> void each(Func &&fn)
+    {
+        constexpr bool shouldBreak = Utilities::ReturnsBool<Func, EntityId, typename Ts::Components &...>;
+
+        refresh();
+
+        for (const auto &id : m_ids)
+        {
+            auto comps = std::make_tuple(std::get<Ts *>(m_sets)->get(id)...);
+            if (!std::apply([](auto &...components) { return (!!components && ...); }, comps))
+                continue;
+
+            if constexpr (shouldBreak)
+            {
+                if (!std::apply([&](auto &...components) { return fn(id, components...); }, comps))
+                    break;
+            }
+            else
+                std::apply([&](auto &...components) { fn(id, components...); }, comps);
+        }
+    }
+
+    /**
+     * @brief Get the number of entities which share all specified component types
+     *
+     * @return size_t
+     */
+    [[nodiscard]] size_t size()
+    {
+        refresh();
+        return m_ids.size();
+    }
+
+    /**
+     * @brief Evaluate by number of entities
+     */
+    [[nodiscard]] explicit operator bool()
+    {
+        return !!size();
+    }
+
+    /**
+     * @brief Get a const reference of the matching entity ids
+     *
+     * @return const std::vector<EntityId>
+     */
+    [[nodiscard]] const std::vector<EntityId> &getIds()
+    {
+        refresh();
+        return m_ids;
+    }
+
+    void onInsert(EntityId id) override
+    {
+        recordChange(id);
+    }
+
+    void onErase(EntityId id) override
+    {
+        recordChange(id);
+    }
+
+    void onClear() override
+    {
+        m_changed.clear();
+        m_shouldRebuild = true;
+    }
+
+    CachedQuery(const CachedQuery &) = delete;
+    CachedQuery &operator=(const CachedQuery &) = delete;
+
+  private:
+    using Entity = EntityTraits<EntityId>;
+    static constexpr size_t npos = PagedSparseArray<EntityId>::npos;
+
+    /**
+     * @brief Record the id to re-check on the next use, or fall back to a rebuild once there are more changes
+     * than ids in the smallest set, so a query which is not used does not grow with the churn of its sets
+     */
+    void recordChange(EntityId id)
+    {
+        if (m_shouldRebuild)
+            return;
+
+        if (m_changed.size() >= std::min({std::get<Ts *>(m_sets)->size()...}))
+        {
+            m_changed.clear();
+            m_shouldRebuild = true;
+            return;
+        }
+
+        m_changed.push_back(id);
+    }
+
+    /**
+     * @brief Bring the matching ids up to date with the changes recorded since the last use
+     */
+    void refresh()
+    {
+        if (m_shouldRebuild)
+        {
+            rebuild();
+            return;
+        }
+
+        for (const auto &id : m_changed)
+        {
+            if ((std::get<Ts *>(m_sets)->contains(id) && ...))
+                insert(id);
+            else
+                erase(id);
+        }
+
+        m_changed.clear();
+    }
+
+    void rebuild()
+    {
+        for (const auto &id : m_ids)
+            m_positions.erase(Entity::getIndex(id));
+
+        m_ids.clear();
+        m_changed.clear();
+        m_shouldRebuild = false;
+
+        std::array<size_t, sizeof...(Ts)> sizes{std::get<Ts *>(m_sets)->size()...};
+        auto smallest = static_cast<size_t>(std::min_element(sizes.begin(), sizes.end()) - sizes.begin());
+
+        size_t index{};
+        (
+            [&]() {
+                if (index++ != smallest)
+                    return;
+
+                for (const auto &id : std::get<Ts *>(m_sets)->m_ids)
+                    m_changed.push_back(id);
+            }(),
+            ...);
+
+        refresh();
+    }
+
+    void insert(EntityId id)
+    {
+        auto position = m_positions.get(Entity::getIndex(id));
+        if (position != npos && m_ids[position] == id)
+            return;
+
+        // A stale generation of the index may still be stored
+        if (position != npos)
+            erase(m_ids[position]);
+
+        m_positions.insert(Entity::getIndex(id), m_ids.size());
+        m_ids.push_back(id);
+    }
+
+    void erase(EntityId id)
+    {
+        auto position = m_positions.get(Entity::getIndex(id));
+        if (position == npos || m_ids[position] != id)
+            return;
+
+        auto lastId = m_ids.back();
+        m_ids[position] = lastId;
+        m_ids.pop_back();
+
+        m_positions.set(Entity::getIndex(lastId), position);
+        m_positions.erase(Entity::getIndex(id));
+    }
+
+    std::tuple<Ts *...> m_sets;
+
+    std::vector<EntityId> m_ids{};
+    PagedSparseArray<EntityId> m_positions{};
+
+    // Ids inserted into or erased from any of the sets since the last use, possibly more than once
+    std::vector<EntityId> m_changed{};
+    bool m_shouldRebuild{false};
+};
+}; // namespace internal
+}; // namespace ECS
@@ -0,0 +1,288 @@
+#pragma once
+
+#include "core.hpp"
+#include "entity_component_manager.hpp"
+#include "macros.hpp"
+#include "utilities.hpp"
+
+namespace ECS
+{
+namespace internal
+{
+
+/**
+ * @brief Records structural changes to apply to the manager later, at a sync point
+ *
+ * Adding or removing components while iterating a set or a group moves the set's dense storage under the loop.
+ * Recording the changes instead, and applying them after the loop, keeps iteration safe.
+ *
+ * Commands are grouped by component type, so each component set is looked up once per apply.  Commands for the
+ * same type are applied in the order they were recorded, and component types are applied in type id order.
+ * Removing or destroying whole entities is applied last, in the order it was recorded.
+ */
+template <typename EntityId> class CommandBuffer
+{
+  private:
+    using Manager = EntityComponentManager<EntityId>;
+
+  public:
+    /**
+     * @param Manager to apply the commands to
+     * @param Mutex guarding entity creation, for buffers which are recorded into from several threads at once
+     */
+    explicit CommandBuffer(Manager &_manager, std::mutex *_entityMutex = nullptr)
+        : m_manager(_manager), m_entityMutex(_entityMutex)
+    {
+    }
+
+    /**
+     * @brief Creates a new entity id right away
+     *
+     * Creating an id never touches a component set, so it is safe during iteration.  Components added to the
+     * id through the buffer are only added once the buffer is applied.
+     *
+     * @return EntityId
+     */
+    EntityId createEntity()
+    {
+        if (!m_entityMutex)
+            return m_manager.createEntity();
+
+        std::lock_guard lock(*m_entityMutex);
+        return m_manager.createEntity();
+    }
+
+    /**
+     * @brief Record adding a component to the entity
+     *
+     * The component is constructed right away, and moved into its set when the buffer is applied.
+     *
+     * @tparam T - Component type
+     *
+     * @param Entity Id
+     * @param Variable arguments for the component constructor
+     */
+    template <typename T, typename... Args> void add(EntityId eId, Args &&...args)
+    {
+        if (eId == 0)
+            return;
+
+        record<T>(Op::ADD, eId, T(std::forward<Args>(args)...));
+    }
+
+    /**
+     * @brief Record overwriting the entity's components of the type
+     *
+     * @tparam T - Component type
+     *
+     * @param Entity Id
+     * @param Variable arguments for the component constructor
+     */
+    template <typename T, typename... Args> void overwrite(EntityId eId, Args &&...args)
+    {
+        if (eId == 0)
+            return;
+
+        record<T>(Op::OVERWRITE, eId, T(std::forward<Args>(args)...));
+    }
+
+    /**
+     * @brief Record removing the entity from the specified sets, or from every set when no type is specified
+     *
+     * @tparam Ts - Component types
+     *
+     * @param Entity Id
+     */
+    template <typename... Ts> void remove(EntityId eId)
+    {
+        if constexpr (sizeof...(Ts) == 0)
+            m_entityCommands.push_back({Op::REMOVE, eId});
+        else
+            (record<Ts>(Op::REMOVE, eId, std::nullopt), ...);
+    }
+
+    /**
+     * @brief Record destroying the entity, which removes every component and recycles its id
+     *
+     * @param Entity Id
+     */
+    void destroyEntity(EntityId eId)
+    {
+        m_entityCommands.push_back({Op::DESTROY, eId});
+    }
+
+    /**
+     * @brief Apply every recorded command to the manager and clear the buffer
+     *
+     * Must not be called while iterating a set or a group of the manager.
+     */
+    void apply()
+    {
+        std::sort(m_usedComponentIds.begin(), m_usedComponentIds.end());
+
+        for (const auto &componentId : m_usedComponentIds)
+            m_commands[componentId]->apply(m_manager);
+
+        for (const auto &[op, eId] : m_entityCommands)
+        {
+            if (op == Op::DESTROY)
+                m_manager.destroyEntity(eId);
+            else
+                m_manager.remove(eId);
+        }
+
+        clear();
+    }
+
+    /**
+     * @brief Drop every recorded command without applying it
+     */
+    void clear()
+    {
+        for (const auto &componentId : m_usedComponentIds)
+            m_commands[componentId]->clear();
+
+        m_usedComponentIds.clear();
+        m_entityCommands.clear();
+    }
+
+    /**
+     * @brief Check whether any command is waiting to be applied
+     */
+    [[nodiscard]] bool empty() const
+    {
+        return m_usedComponentIds.empty() && m_entityCommands.empty();
+    }
+
+    CommandBuffer(const CommandBuffer &) = delete;
+    CommandBuffer &operator=(const CommandBuffer &) = delete;
+
+  private:
+    enum class Op : uint8_t
+    {
+        ADD,
+        OVERWRITE,
+        REMOVE,
+        DESTROY,
+    };
+
+    struct ErasedCommands
+    {
+        virtual ~ErasedCommands() = default;
+        virtual void apply(Manager &manager) = 0;
+        virtual void clear() = 0;
+        virtual bool empty() const = 0;
+    };
+
+    template <typename T> struct ComponentCommands : ErasedCommands
+    {
+        struct Command
+        {
+            Op op;
+            EntityId eId;
+            std::optional<T> value;
+        };
+
+        void record(Op op, EntityId eId, std::optional<T> value)
+        {
+            commands.push_back({op, eId, std::move(value)});
+        }
+
+        void apply(Manager &manager) override
+        {
+            auto cSetPtr = manager.template getComponentSetPtr<T>();
+            for (auto &[op, eId, value] : commands)
+            {
+                switch (op)
+                {
+                case Op::ADD:
+                    if constexpr (Utilities::isUnique<T>())
+                        manager.template addUnique<T>(eId, std::move(*value));
+                    else
+                    {
+                        if (!cSetPtr)
+                            cSetPtr = &manager.template getComponentSet<T>();
+
+                        manager.template addComponentToSet<T>(eId, *cSetPtr, std::move(*value));
+                    }
+                    break;
+                case Op::OVERWRITE:
+                    if (!cSetPtr)
+                        break;
+
+                    if constexpr (Utilities::isUnique<T>())
+                        manager.template overwriteUnique<T>(eId, *cSetPtr, std::move(*value));
+                    else
+                        manager.template overwriteComponent<T>(eId, *cSetPtr, std::move(*value));
+                    break;
+                case Op::REMOVE:
+                    if (cSetPtr)
+                        cSetPtr->erase(eId);
+                    break;
+                default:
+                    break;
+                }
+
+                // Adding a unique component may have created the set
+                if constexpr (Utilities::isUnique<T>())
+                    cSetPtr = manager.template getComponentSetPtr<T>();
+            }
+        }
+
+        void clear() override
+        {
+            commands.clear();
+        }
+
+        bool empty() const override
+        {
+            return commands.empty();
+        }
+
+        std::vector<Command> commands{};
+    };
+
+    struct EntityCommand
+    {
+        Op op;
+        EntityId eId;
+    };
+
+    template <typename T> ComponentCommands<T> &getCommands()
+    {
+        auto componentId = Utilities::getTypeId<T>();
+        if (componentId >= m_commands.size())
+            m_commands.resize(componentId + 1);
+
+        auto &commandsPtr = m_commands[componentId];
+        if (!commandsPtr)
+            commandsPtr = std::make_unique<ComponentCommands<T>>();
+
+        return *static_cast<ComponentCommands<T> *>(commandsPtr.get());
+    }
+
+    /**
+     * @brief Store the command, and mark the type as used once its first command is stored
+     *
+     * The component is constructed before the call, so a throwing constructor leaves the buffer untouched.
+     */
+    template <typename T> void record(Op op, EntityId eId, std::optional<T> value)
+    {
+        auto &commands = getCommands<T>();
+        auto isFirst = commands.empty();
+        commands.record(op, eId, std::move(value));
+
+        if (isFirst)
+            m_usedComponentIds.push_back(Utilities::getTypeId<T>());
+    }
+
+    Manager &m_manager;
+    std::mutex *m_entityMutex;
+
+    // Indexed by component type id, and kept across applies so their storage is reused
+    std::vector<std::unique_ptr<ErasedCommands>> m_commands{};
+    std::vector<size_t> m_usedComponentIds{};
+    std::vector<EntityCommand> m_entityCommands{};
+};
+}; // namespace internal
+}; // namespace ECS
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "core.hpp"
+
+namespace ECS
+{
+namespace internal
+{
+
+/**
+ * @brief Ids of the entities which gained, lost, or had overwritten a component of one type since a drain
+ *
+ * Events are only recorded for types which are observed, and are appended to plain vectors as they happen, so
+ * recording costs a push per event and no callbacks run inside the set.  The vectors keep their capacity
+ * between drains.
+ *
+ * The lists are kept apart, so the order of events for the same entity across lists is lost.  An id may be
+ * added and removed again before the drain, so consumers which need the component should check that it is
+ * still there.
+ */
+template <typename EntityId> struct ComponentEvents
+{
+    // Entities which did not have the component before
+    std::vector<EntityId> added{};
+
+    // Entities which no longer have the component
+    std::vector<EntityId> removed{};
+
+    // Entities whose component was replaced by an overwrite
+    std::vector<EntityId> overwritten{};
+
+    [[nodiscard]] bool empty() const
+    {
+        return added.empty() && removed.empty() && overwritten.empty();
+    }
+
+    void clear()
+    {
+        added.clear();
+        removed.clear();
+        overwritten.clear();
+    }
+};
+}; // namespace internal
+}; // namespace ECS
@@ -0,0 +1,591 @@
+#pragma once
+
+#include "core.hpp"
+#include "macros.hpp"
+#include "tags.hpp"
+#include "utilities.hpp"
+
+namespace ECS
+{
+namespace internal
+{
+
+/**
+ * @brief Tick of the manager's frame counter at which a slot was last added to or changed
+ */
+using ChangeTick = uint32_t;
+
+/**
+ * @brief Dense component storage backing a sparse set
+ *
+ * Non-stacked components are stored directly and contiguously, with a parallel flag marking slots whose
+ * component was removed but have not yet been pruned from the set.
+ *
+ * Stacked components of every slot share a single pool, with each slot owning an [offset, count] range of it.
+ * Adding to the range at the end of the pool grows it in place, while adding to any other full range moves it
+ * to the end.  The space left behind is reclaimed by compacting the pool once it makes up more than half of
+ * it, which also lays the ranges back out in slot order so that a walk over the slots is a linear scan.
+ *
+ * Slots are addressed by the dense index of the owning sparse set.  Component wrappers are views over a single
+ * slot, and are only created when user code asks for them.  Adding components may move the stored components,
+ * so pointers to them should not be held across an add.
+ *
+ * Each slot is stamped with the tick at which it was last added to, overwritten, or mutated, read from the tick
+ * source of the owning manager.  Storage without a tick source stamps every slot with 0.
+ *
+ * When a transformation is set, the transformed components of each slot are cached in a parallel pool laid
+ * out like the components themselves.  A slot's cache goes stale whenever the slot changes, is moved, or the
+ * transformation is set again, and is refilled by the next transformed read of the slot.
+ */
+template <typename T> class ComponentStorage
+{
+  public:
+    static constexpr bool isStacked = Utilities::shouldStack<T>();
+
+    // Called with the context it was set with, so the storage does not own or allocate the pipeline
+    using TransformationFn = T (*)(const void *context, size_t index, const T &component);
+
+    [[nodiscard]] size_t size() const
+    {
+        if constexpr (isStacked)
+            return m_ranges.size();
+        else
+            return m_values.size();
+    }
+
+    void reserve(size_t size)
+    {
+        m_changeTicks.reserve(size);
+        m_values.reserve(size);
+        if constexpr (isStacked)
+            m_ranges.reserve(size);
+        else
+            m_empty.reserve(size);
+    }
+
+    /**
+     * @brief Append a new slot holding a single component
+     */
+    template <typename... Args> void emplace(Args &&...args)
+    {
+        m_changeTicks.push_back(getTick());
+        if constexpr (isStacked)
+            m_ranges.push_back({m_values.size(), 1, 1});
+        else
+            m_empty.push_back(false);
+
+        m_values.emplace_back(std::forward<Args>(args)...);
+        resizeTransformed();
+    }
+
+    /**
+     * @brief Add a component to an existing slot
+     *
+     * Stacked slots gain another instance.  Non-stacked slots can only be refilled after their component was
+     * removed.
+     *
+     * @return Bool - false if the slot is already occupied by a non-stacked component
+     */
+    template <typename... Args> bool emplaceInto(size_t index, Args &&...args)
+    {
+        if constexpr (isStacked)
+        {
+            auto &range = m_ranges[index];
+            if (range.count == range.capacity && range.offset + range.capacity != m_values.size())
+                relocate(index);
+
+            if (range.count < range.capacity)
+                m_values[range.offset + range.count] = T(std::forward<Args>(args)...);
+            else
+            {
+                m_values.emplace_back(std::forward<Args>(args)...);
+                ++range.capacity;
+            }
+
+            ++range.count;
+            if (shouldCompact())
+                compact();
+
+            markChanged(index);
+            resizeTransformed();
+            return true;
+        }
+        else
+        {
+            if (!m_empty[index])
+                return false;
+
+            m_values[index] = T(std::forward<Args>(args)...);
+            m_empty[index] = false;
+            markChanged(index);
+            return true;
+        }
+    }
+
+    /**
+     * @brief Replace everything in the slot with a single component
+     */
+    void overwrite(size_t index, T value)
+    {
+        markChanged(index);
+        if constexpr (isStacked)
+        {
+            auto &range = m_ranges[index];
+            if (!range.capacity)
+            {
+                emplaceInto(index, std::move(value));
+                return;
+            }
+
+            m_values[range.offset] = std::move(value);
+            range.count = 1;
+        }
+        else
+        {
+            m_values[index] = std::move(value);
+            m_empty[index] = false;
+        }
+    }
+
+    /**
+     * @brief Remove the components of the slot for which the function returns true
+     *
+     * The slot itself stays in place until the owning set prunes it.
+     */
+    template <typename Func> void removeIf(size_t index, Func &&fn)
+    {
+        invalidateTransformed(index);
+        if constexpr (isStacked)
+        {
+            auto &range = m_ranges[index];
+            auto first = m_values.begin() + range.offset;
+            auto last = std::remove_if(first, first + range.count, [&](const T &comp) { return fn(comp); });
+            range.count = static_cast<size_t>(last - first);
+        }
+        else
+        {
+            if (!m_empty[index] && fn(static_cast<const T &>(m_values[index])))
+                m_empty[index] = true;
+        }
+    }
+
+    [[nodiscard]] bool isEmpty(size_t index) const
+    {
+        if constexpr (isStacked)
+            return !m_ranges[index].count;
+        else
+            return m_empty[index];
+    }
+
+    [[nodiscard]] size_t count(size_t index) const
+    {
+        if constexpr (isStacked)
+            return m_ranges[index].count;
+        else
+            return m_empty[index] ? 0 : 1;
+    }
+
+    /**
+     * @brief Pointer to the first component of the slot.  Only valid when the slot is not empty
+     */
+    [[nodiscard]] T *data(size_t index)
+    {
+        if constexpr (isStacked)
+            return m_values.data() + m_ranges[index].offset;
+        else
+            return &m_values[index];
+    }
+
+    [[nodiscard]] const T *data(size_t index) const
+    {
+        if constexpr (isStacked)
+            return m_values.data() + m_ranges[index].offset;
+        else
+            return &m_values[index];
+    }
+
+    /**
+     * @brief Move the last slot into the index and drop the last slot
+     */
+    void swapRemove(size_t index)
+    {
+        m_changeTicks[index] = m_changeTicks.back();
+        m_changeTicks.pop_back();
+        invalidateTransformed(index);
+
+        if constexpr (isStacked)
+        {
+            m_unused += m_ranges[index].capacity;
+            m_ranges[index] = m_ranges.back();
+            m_ranges.pop_back();
+
+            if (shouldCompact())
+                compact();
+        }
+        else
+        {
+            auto lastIndex = m_values.size() - 1;
+            if (index != lastIndex)
+            {
+                m_values[index] = std::move(m_values[lastIndex]);
+                m_empty[index] = m_empty[lastIndex];
+            }
+
+            m_values.pop_back();
+            m_empty.pop_back();
+        }
+
+        resizeTransformed();
+    }
+
+    /**
+     * @brief Append a new slot holding the components moved out of another storage's slot
+     *
+     * The source slot is left in place, holding moved-from components, until it is removed.
+     */
+    void appendFrom(ComponentStorage &source, size_t index)
+    {
+        m_changeTicks.push_back(source.m_changeTicks[index]);
+        if constexpr (isStacked)
+        {
+            const auto &range = source.m_ranges[index];
+            auto first = source.m_values.begin() + range.offset;
+
+            m_ranges.push_back({m_values.size(), range.count, range.count});
+            m_values.insert(m_values.end(), std::make_move_iterator(first),
+                            std::make_move_iterator(first + range.count));
+        }
+        else
+        {
+            m_values.push_back(std::move(source.m_values[index]));
+            m_empty.push_back(source.m_empty[index]);
+        }
+
+        resizeTransformed();
+    }
+
+    /**
+     * @brief Append the number of new slots, each holding a copy of the slot's components
+     *
+     * Trivially copyable stacked components are copied a whole range at a time.
+     */
+    void appendCopies(size_t index, size_t count)
+    {
+        m_changeTicks.insert(m_changeTicks.end(), count, getTick());
+        if constexpr (isStacked)
+        {
+            auto range = m_ranges[index];
+            m_ranges.reserve(m_ranges.size() + count);
+            m_values.reserve(m_values.size() + range.count * count);
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                auto offset = m_values.size();
+                m_ranges.push_back({offset, range.count, range.count});
+
+                // Room was reserved up front, so the source range stays valid while the pool grows
+                if constexpr (std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>)
+                {
+                    m_values.resize(offset + range.count);
+                    std::memcpy(m_values.data() + offset, m_values.data() + range.offset,
+                                range.count * sizeof(T));
+                }
+                else
+                {
+                    for (size_t j = 0; j < range.count; ++j)
+                        m_values.push_back(m_values[range.offset + j]);
+                }
+            }
+        }
+        else
+        {
+            T value = m_values[index];
+            m_values.insert(m_values.end(), count, value);
+            m_empty.insert(m_empty.end(), count, m_empty[index]);
+        }
+
+        resizeTransformed();
+    }
+
+    /**
+     * @brief Exchange the contents of two slots
+     */
+    void swap(size_t first, size_t second)
+    {
+        std::swap(m_changeTicks[first], m_changeTicks[second]);
+        invalidateTransformed(first);
+        invalidateTransformed(second);
+        if constexpr (isStacked)
+            std::swap(m_ranges[first], m_ranges[second]);
+        else
+        {
+            std::swap(m_values[first], m_values[second]);
+            std::swap(m_empty[first], m_empty[second]);
+        }
+    }
+
+    void clear()
+    {
+        m_changeTicks.clear();
+        m_values.clear();
+        if constexpr (isStacked)
+        {
+            m_ranges.clear();
+            m_unused = 0;
+        }
+        else
+            m_empty.clear();
+
+        m_transformedValues.clear();
+        m_transformedStates.clear();
+    }
+
+    /**
+     * @brief Move the components of every stacked slot together, in slot order, and drop the unused space
+     */
+    void compact()
+        requires(isStacked)
+    {
+        std::vector<T> values;
+        values.reserve(m_values.size() - m_unused);
+
+        for (auto &range : m_ranges)
+        {
+            auto first = m_values.begin() + range.offset;
+            auto offset = values.size();
+            values.insert(values.end(), std::make_move_iterator(first),
+                          std::make_move_iterator(first + range.count));
+
+            range = {offset, range.count, range.count};
+        }
+
+        m_values = std::move(values);
+        m_unused = 0;
+
+        invalidateTransformed();
+        resizeTransformed();
+    }
+
+    /**
+     * @brief Read the tick to stamp changed slots with from the source, which must outlive the storage
+     */
+    void setTickSource(const ChangeTick *tickSource)
+    {
+        m_tickSource = tickSource;
+    }
+
+    [[nodiscard]] ChangeTick getTick() const
+    {
+        return m_tickSource ? *m_tickSource : 0;
+    }
+
+    /**
+     * @brief Stamp the slot with the current tick
+     */
+    void markChanged(size_t index)
+    {
+        m_changeTicks[index] = getTick();
+        invalidateTransformed(index);
+    }
+
+    /**
+     * @brief Stamp the slots in [begin, end) with the current tick
+     */
+    void markChanged(size_t begin, size_t end)
+    {
+        std::fill(m_changeTicks.begin() + begin, m_changeTicks.begin() + end, getTick());
+        if (!m_transformedStates.empty())
+            std::fill(m_transformedStates.begin() + begin, m_transformedStates.begin() + end,
+                      TRANSFORM_STALE);
+    }
+
+    /**
+     * @brief Get the tick at which the slot was last added to or changed
+     */
+    [[nodiscard]] ChangeTick getChangeTick(size_t index) const
+    {
+        return m_changeTicks[index];
+    }
+
+    /**
+     * @brief Set the function which transforms the components of a slot, or null to remove it
+     *
+     * @param Transformation function
+     * @param Context passed back to the function, which must outlive the storage
+     */
+    void setTransformation(TransformationFn transformationFn, const void *context)
+    {
+        m_transformation = transformationFn;
+        m_transformationContext = context;
+
+        m_transformedValues.clear();
+        m_transformedStates.clear();
+        resizeTransformed();
+    }
+
+    [[nodiscard]] bool hasTransformation() const
+    {
+        return m_transformation;
+    }
+
+    [[nodiscard]] T transform(size_t index, const T &component) const
+    {
+        return m_transformation(m_transformationContext, index, component);
+    }
+
+    /**
+     * @brief Get the transformed components of the slot, only transforming them if the cache is stale
+     *
+     * Safe to call for the same slot from several threads at once, as long as nothing changes the storage in
+     * the meantime.  A thread which finds another one filling the slot's cache does not wait for it.
+     *
+     * @return Pointer to the slot's transformed components, or null while another thread fills the cache
+     */
+    [[nodiscard]] const T *getTransformed(size_t index) const
+    {
+        size_t offset = index;
+        if constexpr (isStacked)
+            offset = m_ranges[index].offset;
+
+        std::atomic_ref<uint8_t> state(m_transformedStates[index]);
+        auto current = state.load(std::memory_order_acquire);
+        if (current == TRANSFORM_CACHED)
+            return m_transformedValues.data() + offset;
+
+        if (current == TRANSFORM_FILLING ||
+            !state.compare_exchange_strong(current, TRANSFORM_FILLING, std::memory_order_acquire))
+            return nullptr;
+
+        for (size_t i = offset, end = offset + count(index); i < end; ++i)
+            m_transformedValues[i] = transform(index, m_values[i]);
+
+        state.store(TRANSFORM_CACHED, std::memory_order_release);
+        return m_transformedValues.data() + offset;
+    }
+
+    /**
+     * @brief Fill the cache of every slot in [begin, end) which is stale, in slot order
+     *
+     * Slots with a cached result or no components are skipped.  Disjoint ranges can be filled from several
+     * threads at once.
+     */
+    void transformRange(size_t begin, size_t end) const
+    {
+        for (auto i = begin; i < end; ++i)
+        {
+            if (!isEmpty(i))
+                static_cast<void>(getTransformed(i));
+        }
+    }
+
+    /**
+     * @brief Mark the cached transformed components of every slot as stale
+     *
+     * Only needed when the transformation depends on more than the entity and its components.
+     */
+    void invalidateTransformed()
+    {
+        std::fill(m_transformedStates.begin(), m_transformedStates.end(), TRANSFORM_STALE);
+    }
+
+  private:
+    // Compaction is skipped for small pools, where the unused space costs less than the copy
+    static constexpr size_t MIN_COMPACT_SIZE = 64;
+
+    // States of a slot's cached transformed components
+    static constexpr uint8_t TRANSFORM_STALE = 0;
+    static constexpr uint8_t TRANSFORM_FILLING = 1;
+    static constexpr uint8_t TRANSFORM_CACHED = 2;
+
+    struct Range
+    {
+        size_t offset{};
+        size_t count{};
+        size_t capacity{};
+    };
+
+    /**
+     * @brief Move the slot's components to the end of the pool so the range can grow
+     *
+     * Default constructible components also get room to double in place, so stacks which are added to in turn
+     * do not move on every add.
+     */
+    void relocate(size_t index)
+        requires(isStacked)
+    {
+        auto &range = m_ranges[index];
+        auto capacity = range.count;
+        if constexpr (std::is_default_constructible_v<T>)
+            capacity = std::max<size_t>(range.count * 2, 2);
+
+        // Pushing elements of the pool into itself must not reallocate, so room is made up front
+        auto required = m_values.size() + capacity + 1;
+        if (required > m_values.capacity())
+            m_values.reserve(std::max(m_values.size() * 2, required));
+
+        auto offset = m_values.size();
+        for (size_t i = 0; i < range.count; ++i)
+            m_values.push_back(std::move(m_values[range.offset + i]));
+
+        if constexpr (std::is_default_constructible_v<T>)
+            m_values.resize(offset + capacity);
+
+        m_unused += range.capacity;
+        range = {offset, range.count, capacity};
+    }
+
+    void invalidateTransformed(size_t index)
+    {
+        if (index < m_transformedStates.size())
+            m_transformedStates[index] = TRANSFORM_STALE;
+    }
+
+    /**
+     * @brief Keep the cache the same shape as the storage, so that reads never have to grow it
+     *
+     * New space is filled with copies of the components, which are replaced once the slot is read.
+     */
+    void resizeTransformed()
+    {
+        if (!m_transformation)
+            return;
+
+        if constexpr (std::is_copy_constructible_v<T>)
+        {
+            if (m_transformedValues.size() < m_values.size())
+                m_transformedValues.insert(m_transformedValues.end(),
+                                           m_values.begin() + m_transformedValues.size(), m_values.end());
+            else
+                m_transformedValues.erase(m_transformedValues.begin() + m_values.size(),
+                                          m_transformedValues.end());
+        }
+
+        m_transformedStates.resize(size(), TRANSFORM_STALE);
+    }
+
+    [[nodiscard]] bool shouldCompact() const
+    {
+        return m_unused >= MIN_COMPACT_SIZE && m_unused * 2 > m_values.size();
+    }
+
+    // Non-stacked components by slot, or the shared pool of stacked components
+    std::vector<T> m_values{};
+    std::vector<uint8_t> m_empty{};
+
+    std::vector<Range> m_ranges{};
+    size_t m_unused{};
+
+    // Tick at which each slot was last added to or changed
+    std::vector<ChangeTick> m_changeTicks{};
+    const ChangeTick *m_tickSource{};
+
+    TransformationFn m_transformation{};
+    const void *m_transformationContext{};
+
+    // Transformed components laid out like the stored components, and the state of each slot's cache.  Filled
+    // by reads, which only ever write to the slot they read
+    mutable std::vector<T> m_transformedValues{};
+    mutable std::vector<uint8_t> m_transformedStates{};
+};
+}; // namespace internal
+}; // namespace ECS
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "component_storage.hpp"
 #include "components_iterator.hpp"
 #include "macros.hpp"
 #include "tags.hpp"
@@ -12,7 +13,27 @@ namespace ECS
 namespace internal
 {
 
-template <typename T> using Transformer = std::function<T(T &)>;
+template <typename T> class ComponentStorage;
+template <typename T> class ReadOnlyComponentsWrapper;
+
+/**
+ * @brief Applies the transformation pipeline of the set which stores the component
+ */
+template <typename T> struct Transformer
+{
+    const ComponentStorage<T> *storage{nullptr};
+    size_t index{};
+
+    explicit operator bool() const
+    {
+        return storage && storage->hasTransformation();
+    }
+
+    [[nodiscard]] T operator()(const T &component) const
+    {
+        return storage->transform(index, component);
+    }
+};
 
 struct DefaultComponent
 {
@@ -33,10 +54,10 @@ enum class Transformation
  * safely access component data Access is very controlled, and some methods are not even available unless
  * certain criteria is met, such as a specific component tag is used
  *
- * Components are stored in various configuration, depending on how their tag and/or how they were created.
- * For instance, NoStack-tagged components are not store or accessed via vector
- * Filtered, narrowed, and sorted components are via a vector of pointers to the original components
- * Transformed components are at this time stored in a vector, regardless of their tag
+ * The wrapper does not own the components of the entity.  It is a lightweight view over a slot of the
+ * component set's storage, which keeps NoStack-tagged components contiguous, and is only created when user
+ * code asks for it.  Filtered, narrowed, and sorted components are via a vector of pointers to the original
+ * components Transformed components are at this time stored in a vector, regardless of their tag
  *
  * Accessor and filtering methods are provided.  However, the only way to make any mutations on a component
  * are via the .mutate method This means every other method either provides const references or copies The
@@ -46,22 +67,13 @@ enum class Transformation
 template <typename T> class ComponentsWrapper
 {
   public:
-    enum class ComponentFlags
-    {
-        NONE = 0,
-        EMPTY,
-    };
-
-    ComponentsWrapper(ComponentFlags _flag)
-    {
-    }
-
-    template <typename... Args> ComponentsWrapper(Args... _args)
-    {
-        emplace(_args...);
-    }
+    /**
+     * @brief Create an empty wrapper
+     */
+    ComponentsWrapper() = default;
 
     template <typename U> using Components = ComponentsWrapper<U>;
+    template <typename U> using ReadOnlyComponents = ReadOnlyComponentsWrapper<U>;
 
     /**
      * @brief Standard read/write for each function
@@ -79,17 +91,27 @@ template <typename T> class ComponentsWrapper
         if (isEmpty())
             return;
 
-        // Cannot perform mutations on transformed components.
-        // Maybe this could change in the future, but as of the time
-        // of writing this, the transformation pipeline implementation
-        // is such that the transformations are overwritten every time
-        // a method is called to ensure the transformations are not stale.
-        //
-        // TODO Task : Reevaluate this and transformation pipelines
+        // Mutations apply to the stored components, which also marks their cached transformations stale
         handleTransformations(Transformation::PRESERVE);
 
         for (auto &comp : *this)
             fn(comp);
+
+        // Filtered, narrowed, and sorted components point into the slot they were taken from
+        if (m_source && (isStored() || isModified()))
+            m_source->markChanged(m_sourceIndex);
+    }
+
+    /**
+     * @brief Check whether the components were added to, overwritten, or mutated at or after the tick
+     *
+     * @param Tick of the manager's frame counter
+     *
+     * @return Bool - false if the wrapper is empty
+     */
+    [[nodiscard]] bool hasChangedSince(ChangeTick tick) const
+    {
+        return isStored() && m_storage->getChangeTick(m_index) >= tick;
     }
 
     /**
@@ -99,7 +121,7 @@ template <typename T> class ComponentsWrapper
      * @param Transformation pipeline behavior
      */
     template <typename Func>
-    void inspect(Func &&fn, Transformation behavior = Transformation::DEFAULT)
+    void inspect(Func &&fn, Transformation behavior = Transformation::DEFAULT) const
         requires std::invocable<Func, const T &>
     {
         static_assert(std::is_convertible_v<std::invoke_result_t<Func, const T &>, void>,
@@ -123,7 +145,7 @@ template <typename T> class ComponentsWrapper
      * @return Data - Some derived data or a copy of a component property
      */
     template <typename P>
-    [[nodiscard]] P derive(auto &&fn, P fallback, Transformation behavior = Transformation::DEFAULT)
+    [[nodiscard]] P derive(auto &&fn, P fallback, Transformation behavior = Transformation::DEFAULT) const
         requires(std::invocable<std::decay_t<decltype(fn)>, const T &> && !Utilities::shouldStack<T>())
     {
         static_assert(std::is_invocable_v<std::decay_t<decltype(fn)>, const T &>,
@@ -149,7 +171,7 @@ template <typename T> class ComponentsWrapper
      * @return Derived data instance
      */
     template <typename P>
-    [[nodiscard]] P derive(auto &&fn, Transformation behavior = Transformation::DEFAULT)
+    [[nodiscard]] P derive(auto &&fn, Transformation behavior = Transformation::DEFAULT) const
         requires(std::invocable<std::decay_t<decltype(fn)>, const T &> && !Utilities::shouldStack<T>())
     {
         static_assert(std::is_invocable_v<std::decay_t<decltype(fn)>, const T &>,
@@ -178,7 +200,7 @@ template <typename T> class ComponentsWrapper
      * @return Component property const reference
      */
     template <typename Prop>
-    [[nodiscard]] const Prop &peek(Transformation behavior, Prop T::*prop)
+    [[nodiscard]] const Prop &peek(Transformation behavior, Prop T::*prop) const
         requires(!Utilities::shouldStack<T>())
     {
         static_assert(!Utilities::shouldStack<T>(), "Cannot use peek method with a stacked component");
@@ -200,7 +222,7 @@ template <typename T> class ComponentsWrapper
      * @return Component property const reference
      */
     template <typename Prop>
-    [[nodiscard]] const Prop &peek(Prop T::*prop)
+    [[nodiscard]] const Prop &peek(Prop T::*prop) const
         requires(!Utilities::shouldStack<T>())
     {
         return peek(Transformation::DEFAULT, prop);
@@ -215,7 +237,7 @@ template <typename T> class ComponentsWrapper
      * @return Container of const references to component properties
      */
     template <typename... Props>
-    [[nodiscard]] std::tuple<const Props &...> peek(Transformation behavior, Props T::*...props)
+    [[nodiscard]] std::tuple<const Props &...> peek(Transformation behavior, Props T::*...props) const
         requires(!Utilities::shouldStack<T>())
     {
         ECS_ASSERT(!isEmpty(), "One or more properties could not be peeked from Component: " +
@@ -235,7 +257,7 @@ template <typename T> class ComponentsWrapper
      * @return Container of const references to component properties
      */
     template <typename... Props>
-    [[nodiscard]] std::tuple<const Props &...> peek(Props T::*...props)
+    [[nodiscard]] std::tuple<const Props &...> peek(Props T::*...props) const
         requires(!Utilities::shouldStack<T>())
     {
         return peek(Transformation::DEFAULT, props...);
@@ -253,32 +275,22 @@ template <typename T> class ComponentsWrapper
     [[nodiscard]] Components<T> filter(Func &&fn, Transformation behavior = Transformation::DEFAULT)
         requires std::invocable<Func, const T &>
     {
-        static_assert(std::is_invocable_v<Func, const T &>,
-                      "Filter function must take const T& as argument.");
-        static_assert(std::is_convertible_v<std::invoke_result_t<Func, const T &>, bool>,
-                      "Filter function must return bool.");
-
-        Components<T> newComps(ComponentFlags::EMPTY);
-        newComps.setTransformer(m_transformer);
-
-        if (isEmpty())
-            return std::move(newComps);
-
-        handleTransformations(behavior);
-        bool shouldFilter = !shouldTransform(behavior);
-
-        for (auto &comp : *this)
-        {
-            if (!fn(comp))
-                continue;
-
-            if (shouldFilter)
-                newComps.modified().push_back(&comp);
-            else
-                newComps.transformed().push_back(T(comp));
-        }
+        return filterComponents(std::forward<Func>(fn), behavior);
+    }
 
-        return std::move(newComps);
+    /**
+     * @brief Filter components, which stay read-only
+     *
+     * @param Function
+     * @param Transformation pipeline behavior
+     *
+     * @return Read-only view of the filtered results
+     */
+    template <typename Func>
+    [[nodiscard]] ReadOnlyComponents<T> filter(Func &&fn, Transformation behavior = Transformation::DEFAULT) const
+        requires std::invocable<Func, const T &>
+    {
+        return ReadOnlyComponents<T>(filterComponents(std::forward<Func>(fn), behavior));
     }
 
     /**
@@ -293,32 +305,22 @@ template <typename T> class ComponentsWrapper
     [[nodiscard]] Components<T> find(Func &&fn, Transformation behavior = Transformation::DEFAULT)
         requires std::invocable<Func, const T &>
     {
-        static_assert(std::is_invocable_v<Func, const T &>, "Find function must take const T& as argument.");
-        static_assert(std::is_convertible_v<std::invoke_result_t<Func, const T &>, bool>,
-                      "Find function must return bool.");
-
-        Components<T> newComps(ComponentFlags::EMPTY);
-        newComps.setTransformer(m_transformer);
-
-        if (isEmpty())
-            return std::move(newComps);
-
-        handleTransformations(behavior);
-
-        for (auto &comp : *this)
-        {
-            if (!fn(comp))
-                continue;
-
-            if (shouldTransform(behavior))
-                newComps.transformed().push_back(T(comp));
-            else
-                newComps.modified().push_back(&comp);
-
-            break;
-        }
+        return findComponents(std::forward<Func>(fn), behavior);
+    }
 
-        return std::move(newComps);
+    /**
+     * @brief Get the first instance of the component which passes the check, which stays read-only
+     *
+     * @param Function
+     * @param Transformation pipeline behavior
+     *
+     * @return Read-only view of the found results
+     */
+    template <typename Func>
+    [[nodiscard]] ReadOnlyComponents<T> find(Func &&fn, Transformation behavior = Transformation::DEFAULT) const
+        requires std::invocable<Func, const T &>
+    {
+        return ReadOnlyComponents<T>(findComponents(std::forward<Func>(fn), behavior));
     }
 
     /**
@@ -326,29 +328,25 @@ template <typename T> class ComponentsWrapper
      *
      * Intended to be used as a companion to .sort()
      *
-     * @param Function
      * @param Transformation pipeline behavior
      *
      * @return New Components wrapper instance containing the first component
      */
     [[nodiscard]] Components<T> first(Transformation behavior = Transformation::DEFAULT)
     {
-        Components<T> newComps(ComponentFlags::EMPTY);
-        newComps.setTransformer(m_transformer);
-
-        if (isEmpty())
-            return std::move(newComps);
-
-        handleTransformations(behavior);
-
-        auto &comp = *begin();
-
-        if (shouldTransform(behavior))
-            newComps.transformed().push_back(T(comp));
-        else
-            newComps.modified().push_back(&comp);
+        return firstComponents(behavior);
+    }
 
-        return std::move(newComps);
+    /**
+     * @brief Get the first component, which stays read-only
+     *
+     * @param Transformation pipeline behavior
+     *
+     * @return Read-only view of the first component
+     */
+    [[nodiscard]] ReadOnlyComponents<T> first(Transformation behavior = Transformation::DEFAULT) const
+    {
+        return ReadOnlyComponents<T>(firstComponents(behavior));
     }
 
     /**
@@ -356,29 +354,25 @@ template <typename T> class ComponentsWrapper
      *
      * Intended to be used as a companion to .sort()
      *
-     * @param Function
      * @param Transformation pipeline behavior
      *
      * @return New Components wrapper instance containing the last component
      */
     [[nodiscard]] Components<T> last(Transformation behavior = Transformation::DEFAULT)
     {
-        Components<T> newComps(ComponentFlags::EMPTY);
-        newComps.setTransformer(m_transformer);
-
-        if (isEmpty())
-            return std::move(newComps);
-
-        handleTransformations(behavior);
-
-        auto &comp = *(end() - 1);
-
-        if (shouldTransform(behavior))
-            newComps.transformed().push_back(T(comp));
-        else
-            newComps.modified().push_back(&comp);
+        return lastComponents(behavior);
+    }
 
-        return std::move(newComps);
+    /**
+     * @brief Get the last component, which stays read-only
+     *
+     * @param Transformation pipeline behavior
+     *
+     * @return Read-only view of the last component
+     */
+    [[nodiscard]] ReadOnlyComponents<T> last(Transformation behavior = Transformation::DEFAULT) const
+    {
+        return ReadOnlyComponents<T>(lastComponents(behavior));
     }
 
     /**
@@ -393,33 +387,22 @@ template <typename T> class ComponentsWrapper
     [[nodiscard]] Components<T> sort(Func &&fn, Transformation behavior = Transformation::DEFAULT)
         requires std::invocable<Func, const T &, const T &>
     {
-        static_assert(std::is_invocable_v<Func, const T &, const T &>,
-                      "Sort function must take two const T& as arguments.");
-        static_assert(std::is_convertible_v<std::invoke_result_t<Func, const T &, const T &>, bool>,
-                      "Sort function must return bool.");
-
-        Components<T> newComps(ComponentFlags::EMPTY);
-        newComps.setTransformer(m_transformer);
-
-        if (isEmpty())
-            return std::move(newComps);
-
-        handleTransformations(behavior);
-        bool isTransformed = !shouldTransform(behavior);
-
-        for (auto &comp : *this)
-        {
-            if (isTransformed)
-                newComps.transformed().push_back(T(comp));
-            else
-                newComps.modified().push_back(&comp);
-        }
-
-        if (newComps.size() > 1)
-            std::sort(newComps.modified().begin(), newComps.modified().end(),
-                      [&](T *a, T *b) { return fn(*a, *b); });
+        return sortComponents(std::forward<Func>(fn), behavior);
+    }
 
-        return std::move(newComps);
+    /**
+     * @brief Get sorted components, which stay read-only
+     *
+     * @param Function
+     * @param Transformation pipeline behavior
+     *
+     * @return Read-only view of the sorted components
+     */
+    template <typename Func>
+    [[nodiscard]] ReadOnlyComponents<T> sort(Func &&fn, Transformation behavior = Transformation::DEFAULT) const
+        requires std::invocable<Func, const T &, const T &>
+    {
+        return ReadOnlyComponents<T>(sortComponents(std::forward<Func>(fn), behavior));
     }
 
     /**
@@ -433,7 +416,7 @@ template <typename T> class ComponentsWrapper
      * @return Reduced Component instance
      */
     template <typename Func>
-    [[nodiscard]] T reduce(Func &&fn, T reduced, Transformation behavior = Transformation::DEFAULT)
+    [[nodiscard]] T reduce(Func &&fn, T reduced, Transformation behavior = Transformation::DEFAULT) const
         requires std::invocable<Func, T &, const T &>
     {
         static_assert(std::is_invocable_v<Func, T &, const T &>,
@@ -467,7 +450,7 @@ template <typename T> class ComponentsWrapper
      * @return Accumulator - Reduced Component instance
      */
     template <typename Func>
-    [[nodiscard]] T reduce(Func &&fn, Transformation behavior = Transformation::DEFAULT)
+    [[nodiscard]] T reduce(Func &&fn, Transformation behavior = Transformation::DEFAULT) const
         requires std::invocable<Func, T &, const T &>
     {
         static_assert(std::is_invocable_v<Func, T &, const T &>,
@@ -495,24 +478,10 @@ template <typename T> class ComponentsWrapper
 
         clearTransformed();
 
-        if (isComponent())
-        {
-            if (fn(*component()))
-                m_component.reset();
-
-            return;
-        }
-
-        if (!isComponents())
+        if (!isStored())
             return;
 
-        for (auto iter = components().begin(); iter != components().end();)
-        {
-            if (fn(*iter))
-                iter = components().erase(iter);
-            else
-                ++iter;
-        }
+        m_storage->removeIf(m_index, fn);
     }
 
     /**
@@ -527,7 +496,7 @@ template <typename T> class ComponentsWrapper
     }
 
 #ifdef ecs_allow_debug
-    void printData()
+    void printData() const
     {
         auto arrangement = getArrangement();
         auto arrangementType = Utilities::getEnumString(arrangement);
@@ -536,22 +505,33 @@ template <typename T> class ComponentsWrapper
 #endif
 
     template <typename EntityId> friend class EntityComponentManager;
+    template <typename Id, typename U> friend class SparseSet;
+    template <typename EntityId> friend class ArchetypeManager;
+    template <typename EntityId, typename... Ts> friend class ArchetypeGrouping;
 
   private:
     using Iterator = ComponentsIterator<T>;
 
-    Iterator begin()
+    ComponentsWrapper(ComponentStorage<T> *_storage, size_t _index)
+        : m_storage(_storage), m_index(_index), m_source(_storage), m_sourceIndex(_index),
+          m_transformer{_storage, _index}
+    {
+    }
+
+    Iterator begin() const
     {
         switch (getArrangement())
         {
         case Arrangement::TRANSFORMED:
+            if (m_cachedTransformed)
+                return Iterator(const_cast<T *>(m_cachedTransformed));
+
             return Iterator(transformed().begin(), Arrangement::TRANSFORMED);
         case Arrangement::MODIFIED:
             return Iterator(modified().begin(), Arrangement::MODIFIED);
         case Arrangement::NOT_STACKED:
-            return Iterator(component());
         case Arrangement::STACKED:
-            return Iterator(components().begin(), Arrangement::STACKED);
+            return Iterator(component());
         default:
             throw std::runtime_error(std::string(Utilities::getEnumString(getArrangement())) + " " +
                                      typeid(T).name() + " arrangement has no iterator!!");
@@ -560,18 +540,20 @@ template <typename T> class ComponentsWrapper
         return Iterator(nullptr);
     }
 
-    Iterator end()
+    Iterator end() const
     {
         switch (getArrangement())
         {
         case Arrangement::TRANSFORMED:
+            if (m_cachedTransformed)
+                return Iterator(const_cast<T *>(m_cachedTransformed) + m_storage->count(m_index));
+
             return Iterator(transformed().end(), Arrangement::TRANSFORMED);
         case Arrangement::MODIFIED:
             return Iterator(modified().end(), Arrangement::MODIFIED);
         case Arrangement::NOT_STACKED:
-            return Iterator(nullptr);
         case Arrangement::STACKED:
-            return Iterator(components().end(), Arrangement::STACKED);
+            return Iterator(component() + m_storage->count(m_index));
         default:
             throw std::runtime_error(std::string(Utilities::getEnumString(getArrangement())) + " " +
                                      typeid(T).name() + " arrangement has no iterator!!");
@@ -580,23 +562,143 @@ template <typename T> class ComponentsWrapper
         return Iterator(nullptr);
     }
 
-    template <typename... Args> void emplace_back(Args &&...args)
+    /*
+     * The read methods build their results as a mutable wrapper, which the const overloads only hand out as a
+     * read-only view
+     */
+    template <typename Func>
+    [[nodiscard]] Components<T> filterComponents(Func &&fn, Transformation behavior) const
+        requires std::invocable<Func, const T &>
     {
-        components().emplace_back(std::forward<Args>(args)...);
+        static_assert(std::is_invocable_v<Func, const T &>,
+                      "Filter function must take const T& as argument.");
+        static_assert(std::is_convertible_v<std::invoke_result_t<Func, const T &>, bool>,
+                      "Filter function must return bool.");
+
+        auto newComps = derived();
+
+        if (isEmpty())
+            return std::move(newComps);
+
+        handleTransformations(behavior);
+        bool shouldFilter = !shouldTransform(behavior);
+
+        for (auto &comp : *this)
+        {
+            if (!fn(comp))
+                continue;
+
+            if (shouldFilter)
+                newComps.modified().push_back(&comp);
+            else
+                newComps.transformed().push_back(T(comp));
+        }
+
+        return std::move(newComps);
     }
 
-    template <typename... Args> void emplace(Args... args)
+    template <typename Func>
+    [[nodiscard]] Components<T> findComponents(Func &&fn, Transformation behavior) const
+        requires std::invocable<Func, const T &>
     {
-        if (!Utilities::shouldStack<T>())
+        static_assert(std::is_invocable_v<Func, const T &>, "Find function must take const T& as argument.");
+        static_assert(std::is_convertible_v<std::invoke_result_t<Func, const T &>, bool>,
+                      "Find function must return bool.");
+
+        auto newComps = derived();
+
+        if (isEmpty())
+            return std::move(newComps);
+
+        handleTransformations(behavior);
+
+        for (auto &comp : *this)
         {
-            m_component.emplace(args...);
-            return;
+            if (!fn(comp))
+                continue;
+
+            if (shouldTransform(behavior))
+                newComps.transformed().push_back(T(comp));
+            else
+                newComps.modified().push_back(&comp);
+
+            break;
+        }
+
+        return std::move(newComps);
+    }
+
+    [[nodiscard]] Components<T> firstComponents(Transformation behavior) const
+    {
+        auto newComps = derived();
+
+        if (isEmpty())
+            return std::move(newComps);
+
+        handleTransformations(behavior);
+
+        auto &comp = *begin();
+
+        if (shouldTransform(behavior))
+            newComps.transformed().push_back(T(comp));
+        else
+            newComps.modified().push_back(&comp);
+
+        return std::move(newComps);
+    }
+
+    [[nodiscard]] Components<T> lastComponents(Transformation behavior) const
+    {
+        auto newComps = derived();
+
+        if (isEmpty())
+            return std::move(newComps);
+
+        handleTransformations(behavior);
+
+        auto &comp = *(end() - 1);
+
+        if (shouldTransform(behavior))
+            newComps.transformed().push_back(T(comp));
+        else
+            newComps.modified().push_back(&comp);
+
+        return std::move(newComps);
+    }
+
+    template <typename Func>
+    [[nodiscard]] Components<T> sortComponents(Func &&fn, Transformation behavior) const
+        requires std::invocable<Func, const T &, const T &>
+    {
+        static_assert(std::is_invocable_v<Func, const T &, const T &>,
+                      "Sort function must take two const T& as arguments.");
+        static_assert(std::is_convertible_v<std::invoke_result_t<Func, const T &, const T &>, bool>,
+                      "Sort function must return bool.");
+
+        auto newComps = derived();
+
+        if (isEmpty())
+            return std::move(newComps);
+
+        handleTransformations(behavior);
+        bool isTransformed = !shouldTransform(behavior);
+
+        for (auto &comp : *this)
+        {
+            if (isTransformed)
+                newComps.transformed().push_back(T(comp));
+            else
+                newComps.modified().push_back(&comp);
         }
 
-        emplace_back(args...);
+        if (newComps.size() > 1)
+            std::sort(newComps.modified().begin(), newComps.modified().end(),
+                      [&](T *a, T *b) { return fn(*a, *b); });
+
+        return std::move(newComps);
     }
 
-    template <typename Prop> [[nodiscard]] const Prop &getConstProp(Prop T::*prop)
+    template <typename Prop> [[nodiscard]] const Prop &getConstProp(Prop T::*prop) const
     {
         return *begin().*prop;
     }
@@ -621,27 +723,25 @@ template <typename T> class ComponentsWrapper
     }
 
   private:
-    [[nodiscard]] std::vector<T *> &modified()
+    [[nodiscard]] std::vector<T *> &modified() const
     {
         return m_modified;
     }
 
-    [[nodiscard]] std::vector<T> &transformed()
+    [[nodiscard]] std::vector<T> &transformed() const
     {
         return m_transformed;
     }
 
-    [[nodiscard]] std::vector<T> &components()
-    {
-        return m_components;
-    }
-
-    [[nodiscard]] T *component()
+    /**
+     * @brief Pointer to the first stored component, or null when nothing is stored
+     */
+    [[nodiscard]] T *component() const
     {
-        if (!m_component.has_value())
+        if (!isStored())
             return nullptr;
 
-        return m_component.operator->();
+        return m_storage->data(m_index);
     }
 
     [[nodiscard]] bool isEmpty() const
@@ -656,17 +756,22 @@ template <typename T> class ComponentsWrapper
 
     [[nodiscard]] bool isTransformed() const
     {
-        return !m_transformed.empty();
+        return m_cachedTransformed || !m_transformed.empty();
+    }
+
+    [[nodiscard]] bool isStored() const
+    {
+        return m_storage && !m_storage->isEmpty(m_index);
     }
 
     [[nodiscard]] bool isComponent() const
     {
-        return m_component.has_value();
+        return !ComponentStorage<T>::isStacked && isStored();
     }
 
     [[nodiscard]] bool isComponents() const
     {
-        return !m_components.empty();
+        return ComponentStorage<T>::isStacked && isStored();
     }
 
     [[nodiscard]] bool isTransformer() const
@@ -674,12 +779,25 @@ template <typename T> class ComponentsWrapper
         return !!m_transformer;
     }
 
+    /**
+     * @brief Create an empty wrapper for components taken from the same slot of the set's storage
+     */
+    [[nodiscard]] Components<T> derived() const
+    {
+        Components<T> newComps;
+        newComps.setTransformer(m_transformer);
+        newComps.m_source = m_source;
+        newComps.m_sourceIndex = m_sourceIndex;
+
+        return newComps;
+    }
+
     void setTransformer(Transformer<T> transformerFn)
     {
         m_transformer = std::move(transformerFn);
     }
 
-    [[nodiscard]] bool shouldTransform(Transformation behavior)
+    [[nodiscard]] bool shouldTransform(Transformation behavior) const
     {
         if (!isTransformer() || isTransformed())
             return false;
@@ -688,18 +806,27 @@ template <typename T> class ComponentsWrapper
                behavior == Transformation::TRANSFORM;
     }
 
-    void createTransformed()
+    void createTransformed() const
     {
+        // Views of a stored slot read the slot's cache, unless another thread is filling it right now
+        if (isStored())
+        {
+            m_cachedTransformed = m_storage->getTransformed(m_index);
+            if (m_cachedTransformed)
+                return;
+        }
+
         for (auto &comp : *this)
             transformed().push_back(m_transformer(comp));
     }
 
-    void clearTransformed()
+    void clearTransformed() const
     {
+        m_cachedTransformed = nullptr;
         transformed().clear();
     }
 
-    void handleTransformations(Transformation behavior)
+    void handleTransformations(Transformation behavior) const
     {
         if (!isTransformer())
             return;
@@ -711,7 +838,7 @@ template <typename T> class ComponentsWrapper
             createTransformed();
     }
 
-    [[nodiscard]] Arrangement getArrangement()
+    [[nodiscard]] Arrangement getArrangement() const
     {
         if (isTransformed())
             return Arrangement::TRANSFORMED;
@@ -729,34 +856,132 @@ template <typename T> class ComponentsWrapper
     }
 
   private:
-    std::vector<T *> m_modified;
-    std::vector<T> m_transformed;
-    std::vector<T> m_components;
-    std::optional<T> m_component;
+    ComponentStorage<T> *m_storage{nullptr};
+    size_t m_index{};
+
+    // Slot which the components were taken from, kept by filtered, narrowed, and sorted wrappers
+    ComponentStorage<T> *m_source{nullptr};
+    size_t m_sourceIndex{};
+
+    // Results of the read methods, which const views can still produce
+    mutable std::vector<T *> m_modified;
+    mutable std::vector<T> m_transformed;
+
+    // The slot's transformed components, cached by the storage
+    mutable const T *m_cachedTransformed{nullptr};
 
-    Transformer<T> m_transformer;
+    Transformer<T> m_transformer{};
 
 #ifdef ecs_allow_debug
   public:
 #else
   private:
 #endif
-    [[nodiscard]] size_t size()
+    [[nodiscard]] size_t size() const
     {
         if (isModified())
             return modified().size();
 
+        if (m_cachedTransformed)
+            return m_storage->count(m_index);
+
         if (isTransformed())
             return transformed().size();
 
-        if (isComponents())
-            return components().size();
-
-        if (isComponent())
-            return 1;
+        if (m_storage)
+            return m_storage->count(m_index);
 
         return 0;
     }
 };
+
+/**
+ * @brief A read-only view of components, returned by the read methods of a const components wrapper
+ *
+ * Only the read methods of the wrapper are exposed, so components which were reached through a const wrapper
+ * stay read-only after being filtered, narrowed, or sorted.
+ */
+template <typename T> class ReadOnlyComponentsWrapper
+{
+  public:
+    /**
+     * @brief Create an empty view
+     */
+    ReadOnlyComponentsWrapper() = default;
+
+    explicit ReadOnlyComponentsWrapper(ComponentsWrapper<T> components) : m_components(std::move(components))
+    {
+    }
+
+    template <typename... Args> void inspect(Args &&...args) const
+    {
+        m_components.inspect(std::forward<Args>(args)...);
+    }
+
+    template <typename P, typename... Args> [[nodiscard]] P derive(Args &&...args) const
+    {
+        return m_components.template derive<P>(std::forward<Args>(args)...);
+    }
+
+    template <typename... Args> [[nodiscard]] decltype(auto) peek(Args &&...args) const
+    {
+        return m_components.peek(std::forward<Args>(args)...);
+    }
+
+    template <typename... Args> [[nodiscard]] ReadOnlyComponentsWrapper filter(Args &&...args) const
+    {
+        return m_components.filter(std::forward<Args>(args)...);
+    }
+
+    template <typename... Args> [[nodiscard]] ReadOnlyComponentsWrapper find(Args &&...args) const
+    {
+        return m_components.find(std::forward<Args>(args)...);
+    }
+
+    template <typename... Args> [[nodiscard]] ReadOnlyComponentsWrapper first(Args &&...args) const
+    {
+        return m_components.first(std::forward<Args>(args)...);
+    }
+
+    template <typename... Args> [[nodiscard]] ReadOnlyComponentsWrapper last(Args &&...args) const
+    {
+        return m_components.last(std::forward<Args>(args)...);
+    }
+
+    template <typename... Args> [[nodiscard]] ReadOnlyComponentsWrapper sort(Args &&...args) const
+    {
+        return m_components.sort(std::forward<Args>(args)...);
+    }
+
+    template <typename... Args> [[nodiscard]] T reduce(Args &&...args) const
+    {
+        return m_components.reduce(std::forward<Args>(args)...);
+    }
+
+    [[nodiscard]] bool hasChangedSince(ChangeTick tick) const
+    {
+        return m_components.hasChangedSince(tick);
+    }
+
+    explicit operator bool() const
+    {
+        return !!m_components;
+    }
+
+#ifdef ecs_allow_debug
+    [[nodiscard]] size_t size() const
+    {
+        return m_components.size();
+    }
+
+    void printData() const
+    {
+        m_components.printData();
+    }
+#endif
+
+  private:
+    ComponentsWrapper<T> m_components{};
+};
 }; // namespace internal
 }; // namespace ECS
@@ -20,9 +20,7 @@ template <typename T> class ComponentsIterator
     std::vector<T>::iterator m_transformedIter;
     bool isTransformed{false};
 
-    std::vector<T>::iterator m_componentsIter;
-    bool isComponents{false};
-
+    // Stored components, stacked or not, are contiguous in the set's storage
     T *m_component;
     bool isComponent{false};
 
@@ -46,10 +44,6 @@ template <typename T> class ComponentsIterator
             isTransformed = true;
             m_transformedIter = _iter;
             break;
-        case Arrangement::STACKED:
-            isComponents = true;
-            m_componentsIter = _iter;
-            break;
         default:
             ECS_LOG_WARNING("Arrangement not found for", ECS::internal::Utilities::getTypeName<T>(), "!")
         }
@@ -60,7 +54,7 @@ template <typename T> class ComponentsIterator
 
     [[nodiscard]] T &operator*()
     {
-        ECS_ASSERT((isModified + isTransformed + isComponents + isComponent) == 1,
+        ECS_ASSERT((isModified + isTransformed + isComponent) == 1,
                    "Iterator has conflicting modes!")
 
         if (isComponent)
@@ -69,8 +63,6 @@ template <typename T> class ComponentsIterator
             return *(*m_modifiedIter);
         if (isTransformed)
             return *m_transformedIter;
-        if (isComponents)
-            return (*m_componentsIter);
 
         ECS_LOG_WARNING("Something has gone wrong if you've reached this point!")
         return *m_component;
@@ -78,24 +70,22 @@ template <typename T> class ComponentsIterator
 
     ComponentsIterator &operator++()
     {
-        ECS_ASSERT((isModified + isTransformed + isComponents + isComponent) == 1,
+        ECS_ASSERT((isModified + isTransformed + isComponent) == 1,
                    "Iterator has conflicting modes!")
 
         if (isComponent)
-            m_component = nullptr;
+            ++m_component;
         else if (isModified)
             ++m_modifiedIter;
         else if (isTransformed)
             ++m_transformedIter;
-        else if (isComponents)
-            ++m_componentsIter;
 
         return *this;
     }
 
     bool operator==(const ComponentsIterator &other) const
     {
-        ECS_ASSERT((isModified + isTransformed + isComponents + isComponent) == 1,
+        ECS_ASSERT((isModified + isTransformed + isComponent) == 1,
                    "Iterator has conflicting modes!")
 
         if (isComponent)
@@ -104,8 +94,6 @@ template <typename T> class ComponentsIterator
             return m_modifiedIter == other.m_modifiedIter;
         if (isTransformed)
             return m_transformedIter == other.m_transformedIter;
-        if (isComponents)
-            return m_componentsIter == other.m_componentsIter;
 
         ECS_LOG_WARNING("Something went wrong if you reached this point!")
         return m_component == other.m_component;
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "core.hpp"
+#include "macros.hpp"
+
+namespace ECS
+{
+namespace internal
+{
+
+/**
+ * @brief Packs an index and a generation into a single entity id
+ *
+ * The low bits hold the index, which is what sparse sets are keyed on.  The high bits hold the generation, which
+ * is bumped every time the index is recycled so that handles to destroyed entities can be told apart from the
+ * entity which reuses their index.  A quarter of the usable bits are given to the generation, eg. 24 index bits
+ * and 8 generation bits for a 32-bit unsigned id.
+ *
+ * Raw ids which are not created by a manager must stay within the index bits, eg. below 2^24 for a 32-bit
+ * unsigned id.  Larger raw ids are read as a generation of a smaller index, so they share that index's slot in
+ * every set, and adds through them are refused as stale whenever the index is already stored.
+ */
+template <typename EntityId> struct EntityTraits
+{
+    static_assert(std::is_integral_v<EntityId>, "Entity ids must be an integral type");
+
+    using Unsigned = std::make_unsigned_t<EntityId>;
+
+    static constexpr size_t bits = sizeof(EntityId) * 8 - std::is_signed_v<EntityId>;
+    static constexpr size_t versionBits = bits / 4;
+    static constexpr size_t indexBits = bits - versionBits;
+
+    static constexpr Unsigned indexMask = (Unsigned{1} << indexBits) - 1;
+    static constexpr Unsigned versionMask = (Unsigned{1} << versionBits) - 1;
+
+    [[nodiscard]] static constexpr Unsigned getIndex(EntityId id)
+    {
+        return static_cast<Unsigned>(id) & indexMask;
+    }
+
+    [[nodiscard]] static constexpr Unsigned getVersion(EntityId id)
+    {
+        return (static_cast<Unsigned>(id) >> indexBits) & versionMask;
+    }
+
+    [[nodiscard]] static constexpr EntityId combine(Unsigned index, Unsigned version)
+    {
+        return static_cast<EntityId>((index & indexMask) | ((version & versionMask) << indexBits));
+    }
+
+    /**
+     * @brief Get the id which will be handed out the next time the index is recycled
+     */
+    [[nodiscard]] static constexpr EntityId nextVersion(EntityId id)
+    {
+        return combine(getIndex(id), getVersion(id) + 1);
+    }
+};
+
+/**
+ * @brief Hands out entity ids, recycling the indexes of destroyed entities with a bumped generation
+ *
+ * Ids up to the reserved count are never handed out, so they can be used directly as well-known entities.
+ */
+template <typename EntityId> class EntityIdPool
+{
+  public:
+    explicit EntityIdPool(EntityId reservedEntities = 0) : m_nextEntityId(reservedEntities)
+    {
+    }
+
+    /**
+     * @brief Creates a new unique entity id, which never matches a handle to a destroyed entity
+     */
+    EntityId create()
+    {
+        if (!m_freeIds.empty())
+        {
+            auto eId = m_freeIds.back();
+            m_freeIds.pop_back();
+            m_entities[Entity::getIndex(eId)] = eId;
+            return eId;
+        }
+
+        auto eId = ++m_nextEntityId;
+        ECS_ASSERT(Entity::getIndex(eId) == eId, "Ran out of entity indexes!")
+
+        auto index = Entity::getIndex(eId);
+        if (index >= m_entities.size())
+            m_entities.resize(index + 1, 0);
+
+        m_entities[index] = eId;
+        return eId;
+    }
+
+    /**
+     * @brief Recycle the id's index
+     *
+     * @return Bool - false if the id was not created by the pool, or was already destroyed
+     */
+    bool destroy(EntityId eId)
+    {
+        if (!isAlive(eId))
+            return false;
+
+        m_entities[Entity::getIndex(eId)] = 0;
+        m_freeIds.push_back(Entity::nextVersion(eId));
+        return true;
+    }
+
+    /**
+     * @brief Check whether the id was created by the pool and has not since been destroyed
+     */
+    [[nodiscard]] bool isAlive(EntityId eId) const
+    {
+        auto index = Entity::getIndex(eId);
+        return eId != 0 && index < m_entities.size() && m_entities[index] == eId;
+    }
+
+  private:
+    using Entity = EntityTraits<EntityId>;
+
+    EntityId m_nextEntityId{0};
+
+    // Current id of every index which has been handed out, or 0 while the index is free
+    std::vector<EntityId> m_entities{};
+
+    // Ids to hand out next, already carrying the bumped generation of their index
+    std::vector<EntityId> m_freeIds{};
+};
+}; // namespace internal
+}; // namespace ECS
@@ -1,10 +1,15 @@
 #pragma once
 
+#include "cached_query.hpp"
 #include "components.hpp"
+#include "entity.hpp"
 #include "grouping.hpp"
 #include "macros.hpp"
+#include "owning_group.hpp"
+#include "signature.hpp"
 #include "sparse_set.hpp"
 #include "tags.hpp"
+#include "thread_pool.hpp"
 #include "utilities.hpp"
 
 namespace ECS
@@ -18,21 +23,49 @@ namespace internal
  */
 template <typename EntityId> class EntityComponentManager
 {
+    template <typename Id> friend class CommandBuffer;
+
   private:
     template <typename T> using Components = ComponentsWrapper<T>;
-    template <typename T> using ComponentSet = SparseSet<EntityId, Components<T>>;
-    template <typename T> using ComponentSetMap = std::unordered_map<size_t, std::unique_ptr<T>>;
+    template <typename T> using ComponentSet = SparseSet<EntityId, T>;
     template <typename... Ts> using ComponentSetGroup = Grouping<EntityId, ComponentSet<Ts>...>;
+    template <typename... Ts> using OwningComponentSetGroup = OwningGrouping<EntityId, ComponentSet<Ts>...>;
+    template <typename... Ts> using ComponentSetQuery = CachedQuery<EntityId, ComponentSet<Ts>...>;
 
     using ErasedComponent = Components<DefaultComponent>;
     using ErasedComponentSet = BaseSparseSet<EntityId, ErasedComponent>;
 
-    using StoredComponents = ComponentSetMap<ErasedComponentSet>;
+    // Component sets indexed by component type id
+    using StoredComponents = std::vector<std::unique_ptr<ErasedComponentSet>>;
     using StoredTags = std::unordered_map<size_t, std::unordered_set<size_t>>;
 
+    // Owning groups indexed by the type id of the group
+    using StoredOwningGroups = std::vector<std::unique_ptr<SetObserver<EntityId>>>;
+
+    // Cached queries indexed by the type id of the query
+    using StoredQueries = std::vector<std::unique_ptr<SetObserver<EntityId>>>;
+
+    using Entity = EntityTraits<EntityId>;
+
     template <typename T> using TransformationFn = std::function<T(EntityId, T)>;
-    using StoredTransformationFn = std::function<DefaultComponent(EntityId, DefaultComponent &)>;
-    using StoredTransformationFnMap = std::unordered_map<size_t, StoredTransformationFn>;
+
+    // Type erased, so the transformations of every component type can be stored together
+    struct ErasedTransformation
+    {
+        virtual ~ErasedTransformation() = default;
+    };
+
+    template <typename T> struct StoredTransformation : ErasedTransformation
+    {
+        explicit StoredTransformation(TransformationFn<T> _fn) : fn(std::move(_fn))
+        {
+        }
+
+        TransformationFn<T> fn;
+    };
+
+    // Transformations indexed by the type id of the component
+    using StoredTransformationFns = std::vector<std::unique_ptr<ErasedTransformation>>;
 
   public:
     /**
@@ -43,8 +76,8 @@ template <typename EntityId> class EntityComponentManager
      * @param setSize - Specific number of elements a set should contain in most cases
      */
     EntityComponentManager(EntityId reservedEntities = 10, size_t minSetSize = 100, size_t setSize = 10024)
+        : m_entityIds(reservedEntities)
     {
-        m_nextEntityId = static_cast<EntityId>(reservedEntities);
         m_minSetSize = minSetSize;
         m_standardSetSize = setSize;
     }
@@ -52,11 +85,152 @@ template <typename EntityId> class EntityComponentManager
     /**
      * @brief Creates a new unique entity id
      *
+     * Indexes of destroyed entities are recycled with a bumped generation, so the returned id never matches a
+     * handle to a destroyed entity.
+     *
      * @return EntityId
      */
     EntityId createEntity()
     {
-        return ++m_nextEntityId;
+        return m_entityIds.create();
+    }
+
+    /**
+     * @brief Creates a new entity with a component of each of the types
+     *
+     * Each component set is looked up once, and the component is inserted directly, without the checks which
+     * add makes for entities that may already have components.  Sets which are locked, or which already store
+     * the new id's index, such as through a raw id, are left alone with a warning.
+     *
+     * @tparam Ts - Component types
+     *
+     * @param Tuples of the constructor arguments of each component, in the order of the types.  Omitting them
+     * default constructs every component
+     *
+     * @return EntityId
+     */
+    template <typename T, typename... Ts, typename... ArgTuples>
+    EntityId createEntity(ArgTuples &&...argTuples)
+    {
+        static_assert(sizeof...(ArgTuples) == 0 || sizeof...(ArgTuples) == sizeof...(Ts) + 1,
+                      "Pass constructor arguments for every component type, or for none of them");
+        static_assert(!Utilities::isUnique<T>() && !(Utilities::isUnique<Ts>() || ...),
+                      "Unique components must be added with add");
+        static_assert(Utilities::areDistinct<T, Ts...>(), "Component types of a new entity must be distinct");
+
+        auto eId = m_entityIds.create();
+        emplaceEach<T, Ts...>(
+            [&]<typename U>(ComponentSet<U> &cSet, auto &&argTuple) {
+                std::apply(
+                    [&](auto &&...args) { cSet.emplaceNew(eId, std::forward<decltype(args)>(args)...); },
+                    std::forward<decltype(argTuple)>(argTuple));
+            },
+            std::forward<ArgTuples>(argTuples)...);
+
+        return eId;
+    }
+
+    /**
+     * @brief Creates entities which each have an identical component of each of the types
+     *
+     * Every component set is looked up and grown once for the whole batch.
+     *
+     * @tparam Ts - Component types
+     *
+     * @param Number of entities
+     * @param Tuples of the constructor arguments of each component, in the order of the types.  Omitting them
+     * default constructs every component
+     *
+     * @return Ids of the new entities
+     */
+    template <typename T, typename... Ts, typename... ArgTuples>
+    std::vector<EntityId> createEntities(size_t count, ArgTuples &&...argTuples)
+    {
+        static_assert(sizeof...(ArgTuples) == 0 || sizeof...(ArgTuples) == sizeof...(Ts) + 1,
+                      "Pass constructor arguments for every component type, or for none of them");
+        static_assert(!Utilities::isUnique<T>() && !(Utilities::isUnique<Ts>() || ...),
+                      "Unique components must be added with add");
+
+        std::vector<EntityId> ids(count);
+        for (auto &id : ids)
+            id = m_entityIds.create();
+
+        emplaceEach<T, Ts...>(
+            [&]<typename U>(ComponentSet<U> &cSet, auto &&argTuple) {
+                cSet.emplaceBulk(std::span<const EntityId>(ids),
+                                 [&](size_t) { return std::make_from_tuple<U>(argTuple); });
+            },
+            std::forward<ArgTuples>(argTuples)...);
+
+        return ids;
+    }
+
+    /**
+     * @brief Creates entities which each have a copy of every component of the source entity
+     *
+     * Each of the source's component sets is grown once and has the copies appended in a single pass, so
+     * spawning many entities from a prefab is much cheaper than getting and adding each component.  Prefabs
+     * can be any entity, such as a reserved id which systems do not otherwise touch.  Unique components are
+     * not cloned.
+     *
+     * @param Entity id to copy the components of
+     * @param Number of entities
+     *
+     * @return Ids of the new entities
+     */
+    std::vector<EntityId> clone(EntityId source, size_t count)
+    {
+        std::vector<EntityId> ids(count);
+        for (auto &id : ids)
+            id = m_entityIds.create();
+
+        if (ids.empty())
+            return ids;
+
+        auto maxId = *std::max_element(ids.begin(), ids.end(), [](EntityId first, EntityId second) {
+            return Entity::getIndex(first) < Entity::getIndex(second);
+        });
+        m_signatures.reserveEntities(maxId);
+        m_signatures.each(source, [&](size_t componentId) { getErasedSet(componentId)->clone(source, ids); });
+
+        return ids;
+    }
+
+    /**
+     * @brief Creates an entity with a copy of every component of the source entity
+     *
+     * @param Entity id to copy the components of
+     *
+     * @return EntityId
+     */
+    EntityId clone(EntityId source)
+    {
+        return clone(source, 1).front();
+    }
+
+    /**
+     * @brief Removes every component of the entity and recycles its id
+     *
+     * Ids which were not created by the manager, such as reserved ids, only have their components removed.
+     *
+     * @param Entity Id
+     */
+    void destroyEntity(EntityId eId)
+    {
+        removeEntity(eId);
+        m_entityIds.destroy(eId);
+    }
+
+    /**
+     * @brief Check whether the id was created by the manager and has not since been destroyed
+     *
+     * @param Entity Id
+     *
+     * @return Bool - true if the entity is alive
+     */
+    [[nodiscard]] bool isAlive(EntityId eId) const
+    {
+        return m_entityIds.isAlive(eId);
     }
 
     /**
@@ -65,6 +239,9 @@ template <typename EntityId> class EntityComponentManager
      * If the component set has not yet been created, it is created before
      * the entity component is added.
      *
+     * Raw ids which were not created by the manager must fit in the index bits of the id, eg. below 2^24 for
+     * a 32-bit unsigned id.  See EntityTraits.
+     *
      * @tparam T - Component type
      * @tparam Ids - Variadiac id arguments
      *
@@ -85,6 +262,45 @@ template <typename EntityId> class EntityComponentManager
         addComponent<T>(eId, args...);
     }
 
+    /**
+     * @brief Constructs and adds a component to each of the entities
+     *
+     * The component set is looked up once, and grown once for all of the ids, so this is much cheaper than
+     * calling add for each id.  Ids of 0 are skipped.
+     *
+     * @tparam T - Component type
+     *
+     * @param Entity ids
+     * @param Variable arguments for the constructor of every component
+     */
+    template <typename T, typename... Args>
+        requires(!(sizeof...(Args) == 1 && (std::is_convertible_v<Args, std::span<const T>> && ...)))
+    void addBulk(std::span<const EntityId> ids, Args... args)
+    {
+        static_assert(!Utilities::isUnique<T>(), "Unique components can only be added to a single entity");
+
+        addBulkToSet<T>(ids, [&](size_t) { return T(args...); });
+    }
+
+    /**
+     * @brief Adds a copy of each value to the entity at the same position
+     *
+     * @tparam T - Component type
+     *
+     * @param Entity ids
+     * @param Components, one for each id
+     */
+    template <typename T> void addBulk(std::span<const EntityId> ids, std::span<const T> values)
+    {
+        static_assert(!Utilities::isUnique<T>(), "Unique components can only be added to a single entity");
+
+        if (ids.size() != values.size())
+            throw std::runtime_error("Bulk add of " + Utilities::getTypeName<T>() +
+                                     " needs one value per id!");
+
+        addBulkToSet<T>(ids, [&](size_t i) { return values[i]; });
+    }
+
     /**
      * @brief Overwrites a components instance for the specified entity
      *
@@ -115,14 +331,16 @@ template <typename EntityId> class EntityComponentManager
     /**
      * @brief Get specified components for the entity
      *
+     * Never modifies storage.  Components which the entity does not have are returned as an empty wrapper.
+     *
      * @tparam Ts - Component types
      * @tparam Ids - Variadiac id arguments
      *
      * @param Entity Id
      *
-     * @return Entity component reference
+     * @return Entity component views
      */
-    template <typename... T> [[nodiscard]] std::tuple<Components<T> &...> get(EntityId eId)
+    template <typename... T> [[nodiscard]] std::tuple<Components<T>...> get(EntityId eId)
     {
         return {getComponents<T>(eId)...};
     }
@@ -140,7 +358,7 @@ template <typename EntityId> class EntityComponentManager
      */
     template <typename T, typename... Ids> [[nodiscard]] auto get(EntityId id, Ids... ids)
     {
-        return getComponentsHelper<T>(getComponentSet<T>(), id, ids...);
+        return getComponentsHelper<T>(getComponentSetPtr<T>(), id, ids...);
     }
 
     /**
@@ -151,36 +369,36 @@ template <typename EntityId> class EntityComponentManager
      * @return Container with the entity id and component
      */
     template <typename T>
-    [[nodiscard]] std::pair<EntityId, Components<T> &> getUnique()
+    [[nodiscard]] std::pair<EntityId, Components<T>> getUnique()
         requires(Utilities::isUnique<T>())
     {
-        auto &cSet = getComponentSet<T>();
         ECS_ASSERT(Utilities::isUnique<T>(), Utilities::getTypeName<T>() + " is not a unique component!");
 
+        auto cSetPtr = getComponentSetPtr<T>();
+        if (!cSetPtr)
+            return {0, Components<T>()};
+
         EntityId id{0};
-        Components<T> *compsPtr;
-        cSet.each([&](EntityId eId, auto &comps) {
+        cSetPtr->each([&](EntityId eId, auto &comps) {
             if (id == 0)
-            {
                 id = eId;
-                compsPtr = &comps;
-            }
             // Should not break the loop after the first element
             // because auto-pruning will clean up dummy components
             // as it iterates over them
         });
 
-        if (compsPtr != nullptr)
-            return {id, *compsPtr};
+        // Pruning moves components around, so the view is only taken once the loop is done
+        if (id != 0)
+            return {id, cSetPtr->get(id)};
 
-        // If the set is empty, create a dummy component for a fake entity
-        std::tuple<Components<T> &> compsTuple = get<T>(0);
-        return {0, std::get<0>(compsTuple)};
+        return {0, Components<T>()};
     }
 
     /**
      * @brief Get the entity ids which are persistent across all specified component types
      *
+     * Ids are in the dense order of the smallest set.
+     *
      * @tparam T - Variadiac type arguments
      *
      * @return Container of entity ids
@@ -189,25 +407,20 @@ template <typename EntityId> class EntityComponentManager
     {
         if constexpr (sizeof...(Ts) == 0)
             return getComponentSet<T>(m_minSetSize).getIds();
+        else
+        {
+            std::tuple<ComponentSet<T> *, ComponentSet<Ts> *...> sets{getComponentSetPtr<T>(),
+                                                                       getComponentSetPtr<Ts>()...};
 
-        auto &cSet = getComponentSet<T>();
-        std::unordered_set<EntityId> ids(cSet.getIds().begin(), cSet.getIds().end());
-        (
-            [&]() {
-                auto &cSet = getComponentSet<Ts>();
-                cSet.prune();
-                for (auto iter = ids.begin(); iter != ids.end();)
-                    iter = cSet.contains(*iter) ? std::next(iter) : ids.erase(iter);
-            }(),
-            ...);
-
-        return std::vector<EntityId>(ids.begin(), ids.end());
+            return getIntersection(sets);
+        }
     }
 
     /**
      * @brief Find overlapping entities for the specified types
      *
-     * Creates a group of entities with all of the specified types in common
+     * Creates a group of entities with all of the specified types in common.  The entities are in the dense
+     * order of the smallest set.
      *
      * @tparam Ts - Component types
      *
@@ -216,48 +429,163 @@ template <typename EntityId> class EntityComponentManager
     // CHANGE NAME: group() , groupCommon() , groupOverlapping() , groupShared() ?
     template <typename... Ts> ComponentSetGroup<Ts...> getGroup()
     {
-        bool shouldBreak{};
-        std::tuple<ComponentSet<Ts> *...> sets{};
-        std::unordered_set<EntityId> ids{};
-        (
-            [&]() {
-                if (shouldBreak)
-                    return;
-
-                auto cSet = getComponentSetPtr<Ts>();
-                if (!cSet)
-                {
-                    ids.clear();
-                    shouldBreak = true;
-                    return;
-                }
-
-                if (ids.empty())
-                {
-                    auto &entityIds = cSet->getIds();
-                    ids = std::unordered_set<EntityId>(entityIds.begin(), entityIds.end());
-                }
-                else
-                {
-                    // TODO Task : Reevalue auto-pruning on the component set
-                    // Maybe do it on .contains(id) call instead, for each set element
-                    // which contains but evaluates to falsy
-                    cSet->prune();
-                    for (auto iter = ids.begin(); iter != ids.end();)
-                        iter = cSet->contains(*iter) ? std::next(iter) : ids.erase(iter);
-                }
-
-                if (!ids.empty())
-                    std::get<ComponentSet<Ts> *>(sets) = cSet;
-                else
-                    shouldBreak = true;
-            }(),
-            ...);
+        std::tuple<ComponentSet<Ts> *...> sets{getComponentSetPtr<Ts>()...};
 
+        auto ids = getIntersection(sets);
         if (ids.empty())
             return ComponentSetGroup<Ts...>();
 
-        return ComponentSetGroup<Ts...>(std::vector<EntityId>(ids.begin(), ids.end()), std::move(sets));
+        return ComponentSetGroup<Ts...>(std::move(ids), std::move(sets));
+    }
+
+    /**
+     * @brief Get the owning group for the specified types, creating it on first use
+     *
+     * The group takes over the dense order of the component sets, keeping entities with all of the types at
+     * the front of each set in the same order.  It is kept up to date as components are added and removed, so
+     * it can be held onto and iterated every frame.  Each component set can only be owned by a single group.
+     *
+     * @tparam Ts - Component types
+     *
+     * @return Owning group reference
+     */
+    template <typename... Ts> OwningComponentSetGroup<Ts...> &getOwningGroup()
+    {
+        static_assert(sizeof...(Ts) > 0, "At least one component type is required");
+
+        auto groupId = Utilities::getTypeId<OwningComponentSetGroup<Ts...>, Utilities::TypeIdFamily::Grouping>();
+        if (groupId >= m_owningGroups.size())
+            m_owningGroups.resize(groupId + 1);
+
+        auto &groupPtr = m_owningGroups[groupId];
+        if (!groupPtr)
+            groupPtr = std::make_unique<OwningComponentSetGroup<Ts...>>(getComponentSet<Ts>()...);
+
+        return *static_cast<OwningComponentSetGroup<Ts...> *>(groupPtr.get());
+    }
+
+    /**
+     * @brief Get the cached query for the specified types, creating it on first use
+     *
+     * The query keeps its matching entity ids between uses, and only re-checks the entities whose components
+     * were added or removed since the last use.  Unlike an owning group, it leaves the order of the component
+     * sets alone, so any number of queries can share the same sets.
+     *
+     * @tparam Ts - Component types
+     *
+     * @return Cached query reference
+     */
+    template <typename... Ts> ComponentSetQuery<Ts...> &getQuery()
+    {
+        static_assert(sizeof...(Ts) > 0, "At least one component type is required");
+
+        auto queryId = Utilities::getTypeId<ComponentSetQuery<Ts...>, Utilities::TypeIdFamily::Grouping>();
+        if (queryId >= m_queries.size())
+            m_queries.resize(queryId + 1);
+
+        auto &queryPtr = m_queries[queryId];
+        if (!queryPtr)
+            queryPtr = std::make_unique<ComponentSetQuery<Ts...>>(getComponentSet<Ts>()...);
+
+        return *static_cast<ComponentSetQuery<Ts...> *>(queryPtr.get());
+    }
+
+    /**
+     * @brief Destroy the cached query for the specified types, if it has been created
+     *
+     * The query stops observing its component sets, and references to it are no longer valid.  The next call to
+     * getQuery creates it again.
+     *
+     * @tparam Ts - Component types
+     */
+    template <typename... Ts> void removeQuery()
+    {
+        auto queryId = Utilities::getTypeId<ComponentSetQuery<Ts...>, Utilities::TypeIdFamily::Grouping>();
+        if (queryId < m_queries.size())
+            m_queries[queryId].reset();
+    }
+
+    /**
+     * @brief Start queueing the add, remove, and overwrite events of the component type
+     *
+     * Events are appended to a queue on the component set as they happen, and are handed over in a single
+     * batch by drainEvents, so reacting to them costs O(events) instead of diffing every id of the set.
+     *
+     * @tparam T - Component type
+     */
+    template <typename T> void observe()
+    {
+        (void)getComponentSet<T>().recordEvents();
+    }
+
+    /**
+     * @brief Hand the events queued since the last drain to the function, then clear them
+     *
+     * @tparam T - Component type
+     *
+     * @param Function which accepts const ComponentEvents<EntityId> &
+     *
+     * @return Bool - false if the type is not observed, in which case the function is not called
+     */
+    template <typename T, typename Func> bool drainEvents(Func &&fn)
+    {
+        auto cSetPtr = getComponentSetPtr<T>();
+        if (!cSetPtr || !cSetPtr->getEvents())
+            return false;
+
+        auto &events = *cSetPtr->getEvents();
+        fn(static_cast<const ComponentEvents<EntityId> &>(events));
+        events.clear();
+        return true;
+    }
+
+    /**
+     * @brief Get the current tick of the frame counter, which components changed now are stamped with
+     *
+     * @return Tick
+     */
+    [[nodiscard]] ChangeTick getTick() const
+    {
+        return m_tick;
+    }
+
+    /**
+     * @brief Move the frame counter on to the next tick
+     *
+     * A system which wants to see every change exactly once reads the changes since the tick it stored last
+     * time, then stores the tick returned here.  Changes made after its read are stamped with the new tick, so
+     * they are seen by its next read.
+     *
+     * @return The new tick
+     */
+    ChangeTick advanceTick()
+    {
+        return ++m_tick;
+    }
+
+    /**
+     * @brief Get the thread pool which parallel loops over the manager's sets and groups run on
+     *
+     * A pool with one thread per hardware thread is created on first use, unless one was passed in.
+     *
+     * @return Thread pool reference
+     */
+    ThreadPool &getThreadPool()
+    {
+        if (!m_threadPool)
+            m_threadPool = std::make_shared<ThreadPool>();
+
+        return *m_threadPool;
+    }
+
+    /**
+     * @brief Use the pool for parallel loops, which lets several managers share their threads
+     *
+     * @param Thread pool, or null to create a default pool on next use
+     */
+    void setThreadPool(std::shared_ptr<ThreadPool> threadPool)
+    {
+        m_threadPool = std::move(threadPool);
     }
 
     /**
@@ -273,25 +601,25 @@ template <typename EntityId> class EntityComponentManager
     }
 
     /**
-     * @brief Check whether or not the component set contains the entity id
+     * @brief Check whether or not the component sets all contain the entity id
      *
-     * @tparam T - Component type
+     * The entity's signature is checked first, so entities missing any of the types are rejected without
+     * touching the component sets.
+     *
+     * @tparam Ts - Component types
      *
      * @param Entity Id
      *
-     * @return Bool - true if contains the entity
+     * @return Bool - true if every set contains the entity
      */
-    template <typename T> [[nodiscard]] bool contains(EntityId eId)
+    template <typename... Ts> [[nodiscard]] bool contains(EntityId eId)
     {
-        auto cSetPtr = getComponentSetPtr<T>();
-        if (!cSetPtr)
-            return false;
+        static_assert(sizeof...(Ts) > 0, "At least one component type is required");
 
-        auto compsPtr = cSetPtr->get(eId);
-        if (!compsPtr || !(*compsPtr))
+        if (!(m_signatures.test(eId, getComponentId<Ts>()) && ...))
             return false;
 
-        return true;
+        return (containsComponent<Ts>(eId) && ...);
     }
 
     /**
@@ -387,18 +715,64 @@ template <typename EntityId> class EntityComponentManager
      */
     template <typename... Ts> void prune()
     {
-        (prune<Ts>(getComponentHash<Ts>()), ...);
+        (prune(getComponentId<Ts>()), ...);
     }
 
     /**
      * @brief Stores a transformation function for the specified component
      *
+     * The function is used by every component of the type, including those added before it was registered.
+     * It is kept by the manager so that it is given to the component's set again if the set is recreated.
+     *
      * @param Transformation function
      */
-    template <typename T> constexpr void registerTransformation(TransformationFn<T> transformationFn)
+    template <typename T> void registerTransformation(TransformationFn<T> transformationFn)
+    {
+        auto componentId = getComponentId<T>();
+        if (componentId >= m_transformationFns.size())
+            m_transformationFns.resize(componentId + 1);
+
+        auto &stored = m_transformationFns[componentId];
+        stored = std::make_unique<StoredTransformation<T>>(std::move(transformationFn));
+
+        if (auto cSetPtr = getComponentSetPtr<T>())
+            cSetPtr->setTransformation(*getTransformation<T>());
+    }
+
+    /**
+     * @brief Run the transformation on the components of every entity in one pass over the set
+     *
+     * Results are cached, so the transformed reads which follow, including the default reads of Transform
+     * tagged components, no longer run the transformation one entity at a time.  Entities whose components
+     * have not changed since they were last transformed are skipped.
+     */
+    template <typename T> void transformAll()
+    {
+        if (auto cSetPtr = getComponentSetPtr<T>())
+            cSetPtr->transformAll();
+    }
+
+    /**
+     * @brief Run the transformation on the components of every entity, in chunks spread over the thread pool
+     *
+     * The transformation is called concurrently, so it must not change any component.
+     */
+    template <typename T> void parallelTransformAll()
+    {
+        if (auto cSetPtr = getComponentSetPtr<T>())
+            cSetPtr->parallelTransformAll(getThreadPool());
+    }
+
+    /**
+     * @brief Recompute the transformed components of every entity on their next transformed read
+     *
+     * Transformed components are cached until the component changes or the transformation is registered
+     * again, so this is only needed when the transformation also depends on state outside of the component.
+     */
+    template <typename T> void invalidateTransformation()
     {
-        auto casted = reinterpret_cast<StoredTransformationFn &>(transformationFn);
-        m_transformationMap.emplace(getComponentHash<T>(), std::move(casted));
+        if (auto cSetPtr = getComponentSetPtr<T>())
+            cSetPtr->invalidateTransformation();
     }
 
     EntityComponentManager(const EntityComponentManager &) = delete;
@@ -425,8 +799,17 @@ template <typename EntityId> class EntityComponentManager
 
     void removeEntity(EntityId eId)
     {
-        for (auto iter = getStoredComponents().begin(); iter != getStoredComponents().end(); ++iter)
-            getSetFromIterator(iter).erase(eId);
+        // Erasing resets the signature bit, which is safe since each word is copied before it is visited
+        m_signatures.each(eId, [&](size_t componentId) { getErasedSet(componentId)->erase(eId); });
+    }
+
+    template <typename T> bool containsComponent(EntityId eId)
+    {
+        auto cSetPtr = getComponentSetPtr<T>();
+        if (!cSetPtr)
+            return false;
+
+        return !!cSetPtr->get(eId);
     }
 
     template <typename T, typename... Args> void addUnique(EntityId eId, Args... args)
@@ -436,7 +819,7 @@ template <typename EntityId> class EntityComponentManager
     }
 
     template <typename T, typename... Args>
-    void overwriteUnique(EntityId eId, ComponentSet<T> cSet, Args... args)
+    void overwriteUnique(EntityId eId, ComponentSet<T> &cSet, Args... args)
     {
         auto [uniqueId, _] = getUnique<T>();
 
@@ -465,36 +848,76 @@ template <typename EntityId> class EntityComponentManager
     }
 #endif
 
-    template <typename T, typename Id> std::tuple<Components<T> &> getComponentsHelper(auto &cSet, Id id)
+    template <typename T, typename Id>
+    std::tuple<Components<T>> getComponentsHelper(ComponentSet<T> *cSetPtr, Id id)
     {
-        return std::tuple<Components<T> &>{getOrCreateComponent<T>(cSet, id)};
+        return std::tuple<Components<T>>{getComponentsOrEmpty<T>(cSetPtr, id)};
     }
 
     template <typename T, typename Id, typename... Rest>
-    auto getComponentsHelper(auto &cSet, Id id, Rest... rest)
+    auto getComponentsHelper(ComponentSet<T> *cSetPtr, Id id, Rest... rest)
+    {
+        return std::tuple_cat(std::tuple<Components<T>>(getComponentsOrEmpty<T>(cSetPtr, id)),
+                              getComponentsHelper<T>(cSetPtr, rest...));
+    }
+
+    /*
+     * @brief Get the ids with components in every set, without hashing
+     *
+     * The smallest set drives the intersection, and each of its ids is probed in the other sets, so the cost
+     * follows the smallest set rather than the largest.  Empty components are skipped instead of pruned, which
+     * would cost a walk over every set.
+     */
+    template <typename... Ts> std::vector<EntityId> getIntersection(std::tuple<ComponentSet<Ts> *...> &sets)
     {
-        Components<T> &firstComponent = getOrCreateComponent<T>(cSet, id);
-        std::tuple<Components<T> &> restComponents = getComponentsHelper<T>(cSet, rest...);
+        if (!(std::get<ComponentSet<Ts> *>(sets) && ...))
+            return {};
+
+        std::array<size_t, sizeof...(Ts)> sizes{std::get<ComponentSet<Ts> *>(sets)->size()...};
+        auto smallest = static_cast<size_t>(std::min_element(sizes.begin(), sizes.end()) - sizes.begin());
+
+        std::vector<EntityId> ids;
+        size_t index{};
+        (
+            [&]() {
+                if (index++ == smallest)
+                    intersectFrom(*std::get<ComponentSet<Ts> *>(sets), sets, ids);
+            }(),
+            ...);
 
-        return std::tuple_cat(std::tuple<Components<T> &>(firstComponent), restComponents);
+        return ids;
+    }
+
+    template <typename T, typename... Ts>
+    void intersectFrom(ComponentSet<T> &driver, std::tuple<ComponentSet<Ts> *...> &sets, std::vector<EntityId> &ids)
+    {
+        ids.reserve(driver.size());
+        for (size_t i = 0; i < driver.m_ids.size(); ++i)
+        {
+            if (driver.m_storage.isEmpty(i))
+                continue;
+
+            auto eId = driver.m_ids[i];
+            if ((std::get<ComponentSet<Ts> *>(sets)->hasComponents(eId) && ...))
+                ids.push_back(eId);
+        }
     }
 
     /*
      * @brief Iterate over specified component sets to cleanup empty sets
      *
-     * @param compHash - Hash of component to prune
+     * @param componentId - Type id of component to prune
      */
-    template <typename T = void *> void prune(size_t compHash)
+    void prune(size_t componentId)
     {
         // TODO Task & Performance : Evaluate memory usage and performance gains
-        auto iter = getStoredComponents().find(compHash);
-        if (iter == getStoredComponents().end())
+        auto cSetPtr = getErasedSet(componentId);
+        if (!cSetPtr)
             return;
 
-        auto &cSet = castErasedTo<T>(iter);
-        cSet.prune();
-        if (!cSet.size())
-            getStoredComponents().erase(iter);
+        cSetPtr->prune();
+        if (!cSetPtr->size())
+            eraseComponentSet(componentId);
     }
 
     template <typename T> ComponentSet<T> &getComponentSet()
@@ -504,111 +927,134 @@ template <typename EntityId> class EntityComponentManager
 
     template <typename T> ComponentSet<T> *getComponentSetPtr()
     {
-        auto hash = getComponentHash<T>();
-        auto iter = getStoredComponents().find(hash);
-        if (iter == getStoredComponents().end())
+        auto cSetPtr = getErasedSet(getComponentId<T>());
+        if (!cSetPtr)
             return nullptr;
 
-        return &castErasedTo<T>(iter);
+        return &castErasedTo<T>(*cSetPtr);
     }
 
     template <typename T> ComponentSet<T> &getComponentSet(size_t maxSize)
     {
-        auto hash = getComponentHash<T>();
-        auto iter = getStoredComponents().find(hash);
-        if (iter == getStoredComponents().end())
-        {
-            createComponentSet<T>(maxSize);
-            iter = getStoredComponents().find(hash);
-        }
-        return castErasedTo<T>(iter);
+        auto cSetPtr = getErasedSet(getComponentId<T>());
+        if (!cSetPtr)
+            cSetPtr = &createComponentSet<T>(maxSize);
+
+        return castErasedTo<T>(*cSetPtr);
     }
 
-    template <typename T> Components<T> &getComponents(EntityId eId)
+    template <typename T> Components<T> getComponents(EntityId eId)
     {
-        auto &cSet = getComponentSet<T>();
-        if (!cSet)
+        auto cSetPtr = getComponentSetPtr<T>();
+        if (!cSetPtr || !(*cSetPtr))
             ECS_ASSERT(!Utilities::isRequired<T>(), Utilities::getTypeName<T>() + " is a required component!")
 
-        return getOrCreateComponent<T>(cSet, eId);
+        return getComponentsOrEmpty<T>(cSetPtr, eId);
     }
 
-    template <typename T> Components<T> &getOrCreateComponent(ComponentSet<T> &cSet, EntityId eId)
+    template <typename T> Components<T> getComponentsOrEmpty(ComponentSet<T> *cSetPtr, EntityId eId)
     {
 #ifdef ecs_allow_debug
         debugCheckForConflictingTags<T>();
 #endif
-        auto comps = cSet.get(eId);
-        if (!comps)
-        {
-            Components<T> dummy{Components<T>::ComponentFlags::EMPTY};
-            if (cSet.isLocked())
-            {
-                cSet.unlock();
-                cSet.insert(eId, std::move(dummy));
-                cSet.lock();
-            }
-            else
-                cSet.insert(eId, std::move(dummy));
-
-            comps = cSet.get(eId);
-        }
+        if (!cSetPtr)
+            return Components<T>();
 
-        return *comps;
+        return cSetPtr->get(eId);
     }
 
     template <typename T, typename... Args> void addComponent(EntityId eId, Args... args)
     {
-        ComponentSet<T> &cSet = getComponentSet<T>();
+        addComponentToSet<T>(eId, getComponentSet<T>(), args...);
+    }
+
+    /**
+     * @brief Call the function with the set of each type and that type's tuple of constructor arguments
+     */
+    template <typename... Ts, typename Func, typename... ArgTuples>
+    void emplaceEach(Func &&fn, ArgTuples &&...argTuples)
+    {
+        if constexpr (sizeof...(ArgTuples) == 0)
+            (fn(getComponentSet<Ts>(), std::tuple<>{}), ...);
+        else
+            (fn(getComponentSet<Ts>(), std::forward<ArgTuples>(argTuples)), ...);
+    }
+
+    template <typename T, typename Func> void addBulkToSet(std::span<const EntityId> ids, Func &&makeComponent)
+    {
+        auto &cSet = getComponentSet<T>();
         ECS_ASSERT(!cSet.isLocked(),
                    "Attempt to add to a locked component set for " + Utilities::getTypeName<T>())
 
-        auto comps = cSet.get(eId);
-        if (!comps)
+        if (std::find(ids.begin(), ids.end(), EntityId{0}) == ids.end())
         {
-            auto newCompsPtr = cSet.emplace(eId, args...);
-            if (!newCompsPtr)
-                return;
-
-            setTransformer(eId, *newCompsPtr);
+            cSet.emplaceBulk(ids, makeComponent);
             return;
         }
 
-        if (!Utilities::shouldStack<T>() && comps->size() >= 1)
+        std::vector<EntityId> validIds;
+        std::vector<size_t> positions;
+        for (size_t i = 0; i < ids.size(); ++i)
         {
-            ECS_LOG_WARNING(eId, "Already contains a NoStack-tagged ", Utilities::getTypeName<T>(),
-                            "Add failed!");
+            if (ids[i] == 0)
+                continue;
+
+            validIds.push_back(ids[i]);
+            positions.push_back(i);
+        }
+
+        cSet.emplaceBulk(std::span<const EntityId>(validIds),
+                         [&](size_t i) { return makeComponent(positions[i]); });
+    }
 
+    template <typename T, typename... Args>
+    void addComponentToSet(EntityId eId, ComponentSet<T> &cSet, Args &&...args)
+    {
+        ECS_ASSERT(!cSet.isLocked(),
+                   "Attempt to add to a locked component set for " + Utilities::getTypeName<T>())
+
+        if (!cSet.contains(eId))
+        {
+            cSet.emplace(eId, std::forward<Args>(args)...);
             return;
         }
 
-        comps->emplace_back(args...);
-        setTransformer(eId, *comps);
+        if (!cSet.emplaceInto(eId, std::forward<Args>(args)...))
+            ECS_LOG_WARNING(eId, "Already contains a NoStack-tagged ", Utilities::getTypeName<T>(),
+                            "Add failed!");
     }
 
     template <typename T, typename... Args>
     void overwriteComponent(EntityId eId, ComponentSet<T> &cSet, Args... args)
     {
-        auto comps = cSet.get(eId);
-        if (!comps)
+        if (!cSet.get(eId))
         {
             ECS_LOG_WARNING(eId, "does not contain", Utilities::getTypeName<T>(), "Overwrite failed!");
             return;
         }
 
-        auto newComps = Components<T>(args...);
-        cSet.overwrite(eId, std::move(newComps));
+        cSet.overwrite(eId, T(args...));
     }
 
-    template <typename T> void createComponentSet(size_t maxSize)
+    template <typename T> ErasedComponentSet &createComponentSet(size_t maxSize)
     {
 #ifdef ecs_allow_debug
         debugCheckForConflictingTags<T>();
 #endif
 
-        auto componentHash = getComponentHash<T>();
-        auto cSet = std::make_unique<ComponentSet<T>>(maxSize, m_standardSetSize);
-        getStoredComponents().insert({componentHash, std::move(cSet)});
+        auto componentId = getComponentId<T>();
+        if (componentId >= getStoredComponents().size())
+            getStoredComponents().resize(componentId + 1);
+
+        auto &cSetPtr = getStoredComponents()[componentId];
+        cSetPtr = std::make_unique<ComponentSet<T>>(maxSize);
+        cSetPtr->m_componentId = componentId;
+        cSetPtr->m_signatures = &m_signatures;
+        m_signatures.reserveComponents(componentId + 1);
+        castErasedTo<T>(*cSetPtr).setTickSource(&m_tick);
+
+        if (auto transformFnPtr = getTransformation<T>())
+            castErasedTo<T>(*cSetPtr).setTransformation(*transformFnPtr);
 
         auto tagHashes = getTagHashes<T>();
 
@@ -621,8 +1067,10 @@ template <typename EntityId> class EntityComponentManager
             if (tagIter == m_tagMap.end())
                 tagIter = m_tagMap.emplace(tagHash, std::unordered_set<size_t>()).first;
 
-            tagIter->second.insert(componentHash);
+            tagIter->second.insert(componentId);
         }
+
+        return *cSetPtr;
     }
 
     template <typename... Ts> void clearComponents()
@@ -633,7 +1081,7 @@ template <typename EntityId> class EntityComponentManager
                 if constexpr (std::is_same_v<Ts, Tags::Event>)
                     clearComponentsByTag<Ts>();
                 else
-                    getStoredComponents().erase(getComponentHash<Ts>());
+                    eraseComponentSet(getComponentId<Ts>());
             }(),
             ...);
     }
@@ -646,8 +1094,8 @@ template <typename EntityId> class EntityComponentManager
             if (!tagHash || m_tagMap.find(tagHash) == m_tagMap.end())
                 continue;
 
-            for (auto &componentHash : m_tagMap[tagHash])
-                getStoredComponents().erase(componentHash);
+            for (auto &componentId : m_tagMap[tagHash])
+                eraseComponentSet(componentId);
 
             m_tagMap.erase(tagHash);
         }
@@ -671,21 +1119,21 @@ template <typename EntityId> class EntityComponentManager
             if (tagIter == m_tagMap.end())
                 continue;
 
-            auto &hashSet = tagIter->second;
-            for (auto &componentHash : hashSet)
+            auto &idSet = tagIter->second;
+            for (auto &componentId : idSet)
             {
-                auto compIter = getStoredComponents().find(componentHash);
-                if (compIter == getStoredComponents().end())
+                auto cSetPtr = getErasedSet(componentId);
+                if (!cSetPtr)
                     continue;
 
-                castErasedTo<Tag>(compIter).each(fn);
+                castErasedTo<Tag>(*cSetPtr).each(fn);
             }
         }
     }
 
-    template <typename T> size_t getComponentHash() const
+    template <typename T> size_t getComponentId() const
     {
-        return typeid(T).hash_code();
+        return Utilities::getTypeId<T>();
     }
 
     template <typename T> const std::array<size_t, 7> getTagHashes() const
@@ -701,56 +1149,69 @@ template <typename EntityId> class EntityComponentManager
         };
     }
 
-    template <typename T> ComponentSet<T> &castErasedTo(StoredComponents::iterator &iter)
+    /*
+     * Sets are only ever stored at the index of their own component id, which is recorded on the set when it is
+     * created, so a static cast is safe.  Debug builds compare the recorded id to catch any misuse.
+     */
+    template <typename T> ComponentSet<T> &castErasedTo(ErasedComponentSet &cSet)
     {
-#ifdef ecs_unsafe_casts
-        return *static_cast<ComponentSet<T> *>(&getSetFromIterator(iter));
-#else
-        auto casted = dynamic_cast<ComponentSet<T> *>(&getSetFromIterator(iter));
-        ECS_ASSERT(casted, Utilities::getTypeName<T>() + " Failed dynamic_cast!")
-
-        return *casted;
+#ifdef ecs_allow_debug
+        ECS_ASSERT(cSet.getComponentId() == getComponentId<T>(), Utilities::getTypeName<T>() + " Failed cast!")
 #endif
+        return *static_cast<ComponentSet<T> *>(&cSet);
     }
 
-    template <typename T> void setTransformer(EntityId eId, Components<T> &comps)
+    // Transformations are only stored at the index of their own component id, so a static cast is safe
+    template <typename T> TransformationFn<T> *getTransformation()
     {
-        TransformationFn<T> *transformFnPtr = getTransformation<T>(eId);
-        if (!transformFnPtr)
-            return;
+        auto componentId = getComponentId<T>();
+        if (componentId >= m_transformationFns.size() || !m_transformationFns[componentId])
+            return nullptr;
 
-        auto &transformationFn = *transformFnPtr;
-        comps.setTransformer(
-            [&, eId, transformationFn](T &component) -> T { return transformationFn(eId, component); });
+        return &static_cast<StoredTransformation<T> &>(*m_transformationFns[componentId]).fn;
     }
 
-    template <typename T> TransformationFn<T> *getTransformation(EntityId eId)
+    StoredComponents &getStoredComponents()
     {
-        auto hash = getComponentHash<T>();
-        auto iter = m_transformationMap.find(hash);
+        return m_componentSets;
+    }
 
-        if (iter == m_transformationMap.end())
+    ErasedComponentSet *getErasedSet(size_t componentId)
+    {
+        if (componentId >= getStoredComponents().size())
             return nullptr;
 
-        auto &uncastedFn = iter->second;
-        return &reinterpret_cast<TransformationFn<T> &>(uncastedFn);
+        return getStoredComponents()[componentId].get();
     }
 
-    StoredComponents &getStoredComponents()
+    void eraseComponentSet(size_t componentId)
     {
-        return m_componentMap;
-    }
+        if (componentId >= getStoredComponents().size())
+            return;
 
-    ErasedComponentSet &getSetFromIterator(StoredComponents::iterator &iter)
-    {
-        return *iter->second;
+        // Owning groups and queries hold onto their sets, so those sets are only emptied
+        auto &cSetPtr = getStoredComponents()[componentId];
+        if (cSetPtr && cSetPtr->isObserved())
+            cSetPtr->clear();
+        else
+            cSetPtr.reset();
     }
 
   private:
-    StoredComponents m_componentMap{};
+    // Frame counter which components are stamped with when they change.  Starts above 0, so reading the changes
+    // since tick 0 sees every component
+    ChangeTick m_tick{1};
+
+    // Declared before the sets, which reset their signature bits when destroyed
+    EntitySignatures<EntityId> m_signatures{};
+    StoredComponents m_componentSets{};
+    // Declared after the sets, which must outlive the groups and queries observing them
+    StoredOwningGroups m_owningGroups{};
+    StoredQueries m_queries{};
+    std::shared_ptr<ThreadPool> m_threadPool{};
     StoredTags m_tagMap{};
-    StoredTransformationFnMap m_transformationMap{};
-    EntityId m_nextEntityId{0};
+    StoredTransformationFns m_transformationFns{};
+    EntityIdPool<EntityId> m_entityIds;
 
     size_t m_standardSetSize = 10024;
     size_t m_minSetSize = 100;
@@ -763,21 +1224,8 @@ template <typename EntityId> class EntityComponentManager
      */
     void pruneAll()
     {
-        for (auto iter = getStoredComponents().begin(); iter != getStoredComponents().end();)
-        {
-            std::vector<EntityId> ids;
-
-            auto &cSet = getSetFromIterator(iter);
-            cSet.prune();
-
-            if (iter->first, !cSet.size())
-            {
-                iter = getStoredComponents().erase(iter);
-                continue;
-            }
-
-            ++iter;
-        }
+        for (size_t componentId = 0; componentId < getStoredComponents().size(); ++componentId)
+            prune(componentId);
     }
 
     /*
@@ -809,10 +1257,10 @@ template <typename EntityId> class EntityComponentManager
             if (tagIter == m_tagMap.end())
                 continue;
 
-            auto &hashSet = tagIter->second;
-            for (auto &componentHash : hashSet)
+            auto &idSet = tagIter->second;
+            for (auto &componentId : idSet)
             {
-                prune<Tag>(componentHash);
+                prune(componentId);
             }
         }
     }
@@ -824,24 +1272,9 @@ template <typename EntityId> class EntityComponentManager
 #else
   private:
 #endif
-    template <typename... Ts> [[nodiscard]] std::tuple<Components<Ts> *...> getUnsafe(EntityId eId)
+    template <typename... Ts> [[nodiscard]] std::tuple<Components<Ts>...> getUnsafe(EntityId eId)
     {
-        std::tuple<Components<Ts> *...> components{};
-
-        (
-            [&]() {
-                auto cSetPtr = getComponentSetPtr<Ts>();
-                if (!cSetPtr)
-                {
-                    std::get<Components<Ts> *>(components) = nullptr;
-                    return;
-                }
-
-                std::get<Components<Ts> *>(components) = cSetPtr->get(eId);
-            }(),
-            ...);
-
-        return components;
+        return {getComponentsOrEmpty<Ts>(getComponentSetPtr<Ts>(), eId)...};
     }
 
     template <typename... Ts> [[nodiscard]] std::tuple<ComponentSet<Ts> *...> getAllUnsafe()
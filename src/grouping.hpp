@@ -1,6 +1,8 @@
 #pragma once
 
+#include "component_storage.hpp"
 #include "macros.hpp"
+#include "thread_pool.hpp"
 #include "utilities.hpp"
 
 namespace ECS
@@ -19,7 +21,8 @@ template <typename EntityId, typename... Ts> class Grouping
 
   public:
     Grouping(std::vector<EntityId> _ids = {}) {};
-    Grouping(std::vector<EntityId> _ids, std::tuple<Ts *...> _values) : m_ids(_ids), m_values(_values) {};
+    Grouping(std::vector<EntityId> _ids, std::tuple<Ts *...> _values)
+        : m_ids(std::move(_ids)), m_values(_values) {};
 
     /**
      * @brief Iterate over component set and pass the entity components into the function
@@ -31,11 +34,115 @@ template <typename EntityId, typename... Ts> class Grouping
      */
     template <typename Func> void each(Func &&fn)
     {
-        if constexpr (Utilities::ReturnsBool<Func, EntityId, Ts...>)
+        if constexpr (Utilities::ReturnsBool<Func, EntityId, typename Ts::Components &...>)
             eachWithBreak(fn);
         else
             eachNoBreak(fn);
 
+#ifdef ecs_allow_experimental
+        m_filterFn.reset();
+#endif
+    }
+
+    /**
+     * @brief Read-only iteration over the group, which passes the entity components as const wrappers
+     *
+     * The function argument can optionally return a bool to determine the loop-breaking behavior.
+     * A false return value is a break.
+     *
+     * Nothing is pruned or otherwise changed in the component sets, so groups over the same sets can safely
+     * be inspected at the same time.
+     *
+     * @param Function which accepts the entity id and const component types
+     */
+    template <typename Func> void inspectEach(Func &&fn) const
+    {
+        constexpr bool shouldBreak =
+            Utilities::ReturnsBool<Func, EntityId, const typename Ts::Components &...>;
+
+        for (const auto &id : m_ids)
+        {
+#ifdef ecs_allow_experimental
+            if (!passesFilter(id))
+                continue;
+#endif
+            const auto comps = std::make_tuple(std::get<Ts *>(m_values)->get(id)...);
+            if constexpr (shouldBreak)
+            {
+                if (!std::apply([&](const auto &...components) { return fn(id, components...); }, comps))
+                    break;
+            }
+            else
+                std::apply([&](const auto &...components) { fn(id, components...); }, comps);
+        }
+    }
+
+    /**
+     * @brief Each loop over only the entities whose component of the type changed at or after the tick
+     *
+     * The function argument can optionally return a bool to determine the loop-breaking behavior.
+     * A false return value is a break.
+     *
+     * The change tick is checked before any of the other components are looked up.
+     *
+     * @tparam U - Component type to check for changes
+     *
+     * @param Tick of the manager's frame counter
+     * @param Function which accepts the entity id and component types
+     */
+    template <typename U, typename Func> void eachChangedSince(ChangeTick tick, Func &&fn)
+    {
+        constexpr auto setIndex = getSetIndex<U>();
+        static_assert(setIndex < sizeof...(Ts), "The component type must be one of the group's types.");
+
+        auto changedSet = std::get<setIndex>(m_values);
+        for (const auto &id : m_ids)
+        {
+            if (!changedSet->get(id).hasChangedSince(tick))
+                continue;
+
+            auto comps = std::make_tuple(std::get<Ts *>(m_values)->get(id)...);
+            if constexpr (Utilities::ReturnsBool<Func, EntityId, typename Ts::Components &...>)
+            {
+                if (!std::apply([&](auto &...components) { return fn(id, components...); }, comps))
+                    break;
+            }
+            else
+                std::apply([&](auto &...components) { fn(id, components...); }, comps);
+        }
+    }
+
+    /**
+     * @brief Each loop split into chunks of the entity ids, which run on the threads of the pool
+     *
+     * The function is called concurrently, so it may only read and mutate the components it is passed.
+     * Adding, removing, or mutating the components of any other entity during the call is not allowed, and
+     * loops can not be broken out of.
+     *
+     * @param Thread pool to run the chunks on
+     * @param Function which accepts the entity id and component types
+     * @param Number of entity ids per chunk
+     */
+    template <typename Func>
+    void parallelEach(ThreadPool &pool, Func &&fn, size_t chunkSize = ThreadPool::DEFAULT_CHUNK_SIZE)
+    {
+        static_assert(!Utilities::ReturnsBool<Func, EntityId, typename Ts::Components &...>,
+                      "Parallel each loops can not break.");
+
+        std::tuple<typename Ts::ParallelIterationGuard...> guards(std::get<Ts *>(m_values)...);
+        pool.parallelFor(m_ids.size(), chunkSize, [&](size_t begin, size_t end) {
+            for (auto i = begin; i < end; ++i)
+            {
+                const auto &id = m_ids[i];
+#ifdef ecs_allow_experimental
+                if (!passesFilter(id))
+                    continue;
+#endif
+                auto comps = std::make_tuple(std::get<Ts *>(m_values)->get(id)...);
+                std::apply([&](auto &...components) { fn(id, components...); }, comps);
+            }
+        });
+
 #ifdef ecs_allow_experimental
         m_filterFn.reset();
 #endif
@@ -72,6 +179,18 @@ template <typename EntityId, typename... Ts> class Grouping
     }
 
   private:
+    template <typename U> static constexpr size_t getSetIndex()
+    {
+        constexpr std::array<bool, sizeof...(Ts)> matches{std::is_same_v<typename Ts::Component, U>...};
+        for (size_t i = 0; i < matches.size(); ++i)
+        {
+            if (matches[i])
+                return i;
+        }
+
+        return sizeof...(Ts);
+    }
+
     template <typename Func> void eachWithBreak(Func &&fn)
     {
         for (const auto &id : m_ids)
@@ -81,7 +200,8 @@ template <typename EntityId, typename... Ts> class Grouping
                 continue;
 #endif
             // TODO Safety : Add null set check and handling
-            if (!fn(id, *std::get<Ts *>(m_values)->get(id)...))
+            auto comps = std::make_tuple(std::get<Ts *>(m_values)->get(id)...);
+            if (!std::apply([&](auto &...components) { return fn(id, components...); }, comps))
                 break;
         }
     }
@@ -95,7 +215,8 @@ template <typename EntityId, typename... Ts> class Grouping
                 continue;
 #endif
             // TODO Safety : Add null set check and handling
-            fn(id, *std::get<Ts *>(m_values)->get(id)...);
+            auto comps = std::make_tuple(std::get<Ts *>(m_values)->get(id)...);
+            std::apply([&](auto &...components) { fn(id, components...); }, comps);
         }
     }
 
@@ -103,7 +224,7 @@ template <typename EntityId, typename... Ts> class Grouping
   private:
     std::optional<std::function<bool(EntityId)>> m_filterFn;
 
-    bool passesFilter(EntityId id)
+    bool passesFilter(EntityId id) const
     {
         if (!m_filterFn.has_value())
             return true;
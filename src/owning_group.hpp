@@ -0,0 +1,187 @@
+#pragma once
+
+#include "base_sparse_set.hpp"
+#include "core.hpp"
+#include "macros.hpp"
+#include "utilities.hpp"
+
+namespace ECS
+{
+namespace internal
+{
+
+/**
+ * @brief A grouping which owns the dense order of its component sets
+ *
+ * Entities with every owned component are kept at the front of each owned set, at the same dense index in each
+ * of them.  Adding and removing components moves entities in and out of that shared prefix as it happens, so
+ * iterating the group is a lockstep walk over contiguous storage, with no sparse lookups and no id vector.
+ *
+ * Each set can be owned by a single group.  Adding or removing components of the owned types while iterating
+ * the group moves entities within the prefix, so those changes should go through a command buffer instead.
+ */
+template <typename EntityId, typename... Ts> class OwningGrouping : public SetObserver<EntityId>
+{
+  public:
+    explicit OwningGrouping(Ts &..._sets) : m_sets(&_sets...)
+    {
+        if ((_sets.m_owner || ...))
+            throw std::runtime_error("One or more component sets are already owned by another group!");
+
+        ((_sets.m_owner = this), ...);
+
+        // Build the prefix from whichever set is smallest
+        std::array<size_t, sizeof...(Ts)> sizes{_sets.size()...};
+        auto smallest = static_cast<size_t>(std::min_element(sizes.begin(), sizes.end()) - sizes.begin());
+
+        std::vector<EntityId> ids;
+        size_t index{};
+        (
+            [&]() {
+                if (index++ == smallest)
+                    ids = _sets.m_ids;
+            }(),
+            ...);
+
+        for (const auto &id : ids)
+            onInsert(id);
+    }
+
+    ~OwningGrouping() override
+    {
+        ((std::get<Ts *>(m_sets)->m_owner = nullptr), ...);
+    }
+
+    /**
+     * @brief Iterate over the group and pass the entity components into the function
+     *
+     * The function argument can optionally return a bool to determine the loop-breaking behavior.
+     * A false return value is a break.
+     *
+     * Entities whose components have all been removed, but not yet pruned, are skipped.
+     *
+     * @param Function which accepts the entity id and component types
+     */
+    template <typename Func> void each(Func &&fn)
+    {
+        constexpr bool shouldBreak = Utilities::ReturnsBool<Func, EntityId, typename Ts::Components &...>;
+
+        const auto &ids = std::get<0>(m_sets)->m_ids;
+        for (size_t i = 0; i < m_size; ++i)
+        {
+            if ((std::get<Ts *>(m_sets)->m_storage.isEmpty(i) || ...))
+                continue;
+
+            auto comps = std::make_tuple(std::get<Ts *>(m_sets)->getByDenseIndex(i)...);
+            if constexpr (shouldBreak)
+            {
+                if (!std::apply([&](auto &...components) { return fn(ids[i], components...); }, comps))
+                    break;
+            }
+            else
+                std::apply([&](auto &...components) { fn(ids[i], components...); }, comps);
+        }
+    }
+
+    /**
+     * @brief NON-STACKED COMPONENTS ONLY! Iterate over the raw components of the group in contiguous chunks
+     *
+     * The function is passed a span of ids, and a span of components for each owned type, all at the same
+     * dense indexes.  Entities with an empty value in any of the sets are skipped.  Components are passed as
+     * stored, without applying any transformation pipeline, so loops can be vectorized across entities.
+     *
+     * The function argument can optionally return a bool to determine the loop-breaking behavior.
+     * A false return value is a break.
+     *
+     * @param Function which accepts std::span<const EntityId> and a std::span of each component type
+     * @param Maximum number of entities per chunk
+     */
+    template <typename Func>
+    void eachChunk(Func &&fn, size_t chunkSize = FirstSet::DEFAULT_CHUNK_SIZE)
+        requires(!ComponentStorage<typename Ts::Component>::isStacked && ...)
+    {
+        static_assert(
+            std::is_invocable_v<Func, std::span<const EntityId>, std::span<typename Ts::Component>...>,
+            "Chunk function must take a span of ids and a span of each component type as arguments.");
+
+        const auto &ids = std::get<0>(m_sets)->m_ids;
+        auto isSkipped = [&](size_t i) { return (std::get<Ts *>(m_sets)->m_storage.isEmpty(i) || ...); };
+
+        Utilities::forEachRun(m_size, chunkSize, isSkipped, [&](size_t begin, size_t end) {
+            (std::get<Ts *>(m_sets)->m_storage.markChanged(begin, end), ...);
+            return fn(std::span<const EntityId>(ids.data() + begin, end - begin),
+                      std::span<typename Ts::Component>(std::get<Ts *>(m_sets)->m_storage.data(begin),
+                                                        end - begin)...);
+        });
+    }
+
+    /**
+     * @brief Get the number of entities which have all of the owned component types
+     *
+     * @return size_t
+     */
+    [[nodiscard]] size_t size() const
+    {
+        return m_size;
+    }
+
+    /**
+     * @brief Evaluate by number of entities
+     */
+    [[nodiscard]] explicit operator bool() const
+    {
+        return !!m_size;
+    }
+
+    /**
+     * @brief Get the entity ids of the group, in iteration order
+     *
+     * The ids are a view into the owned sets, and are invalidated by structural changes to them.
+     *
+     * @return std::span<const EntityId>
+     */
+    [[nodiscard]] std::span<const EntityId> getIds() const
+    {
+        return {std::get<0>(m_sets)->m_ids.data(), m_size};
+    }
+
+    void onInsert(EntityId id) override
+    {
+        if (!(std::get<Ts *>(m_sets)->contains(id) && ...) || isMember(id))
+            return;
+
+        (std::get<Ts *>(m_sets)->swapDense(std::get<Ts *>(m_sets)->getDenseIndex(id), m_size), ...);
+        ++m_size;
+    }
+
+    void onErase(EntityId id) override
+    {
+        if (!isMember(id))
+            return;
+
+        --m_size;
+        (std::get<Ts *>(m_sets)->swapDense(std::get<Ts *>(m_sets)->getDenseIndex(id), m_size), ...);
+    }
+
+    void onClear() override
+    {
+        m_size = 0;
+    }
+
+    OwningGrouping(const OwningGrouping &) = delete;
+    OwningGrouping &operator=(const OwningGrouping &) = delete;
+
+  private:
+    using FirstSet = std::tuple_element_t<0, std::tuple<Ts...>>;
+
+    [[nodiscard]] bool isMember(EntityId id) const
+    {
+        auto index = std::get<0>(m_sets)->getDenseIndex(id);
+        return index < m_size;
+    }
+
+    std::tuple<Ts *...> m_sets;
+    size_t m_size{};
+};
+}; // namespace internal
+}; // namespace ECS
@@ -0,0 +1,150 @@
+#pragma once
+
+#include "core.hpp"
+#include "macros.hpp"
+
+namespace ECS
+{
+namespace internal
+{
+
+/**
+ * @brief Number of sparse entries per page.  Must be a power of two
+ */
+inline constexpr size_t SPARSE_PAGE_SIZE = 1024;
+
+/**
+ * @brief A sparse array split into fixed-size pages
+ *
+ * Maps entity ids to dense indexes.  Pages are allocated the first time an id within their range is inserted,
+ * and are freed again once the last id within their range is erased, so memory usage follows the ids which are
+ * actually stored instead of the largest id ever stored.
+ */
+template <typename Id> class PagedSparseArray
+{
+  public:
+    static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+    [[nodiscard]] bool contains(Id id) const
+    {
+        return get(id) != npos;
+    }
+
+    /**
+     * @brief Get the dense index stored for the id
+     *
+     * @return Dense index, or npos if the id is not stored
+     */
+    [[nodiscard]] size_t get(Id id) const
+    {
+        auto pageIndex = getPageIndex(id);
+        if (pageIndex >= m_pages.size() || !m_pages[pageIndex])
+            return npos;
+
+        auto index = m_pages[pageIndex]->values[getOffset(id)];
+        return index != EMPTY ? index : npos;
+    }
+
+    void insert(Id id, size_t index)
+    {
+        ECS_ASSERT(index < EMPTY, "Dense index exceeds the sparse page value range")
+
+        auto pageIndex = getPageIndex(id);
+        if (pageIndex >= m_pages.size())
+            m_pages.resize(pageIndex + 1);
+
+        auto &page = m_pages[pageIndex];
+        if (!page)
+        {
+            page = std::make_unique<Page>();
+            page->values.fill(EMPTY);
+        }
+
+        auto &value = page->values[getOffset(id)];
+        if (value == EMPTY)
+            ++page->count;
+
+        value = static_cast<uint32_t>(index);
+    }
+
+    /**
+     * @brief Update the dense index of an id which is already stored
+     */
+    void set(Id id, size_t index)
+    {
+        m_pages[getPageIndex(id)]->values[getOffset(id)] = static_cast<uint32_t>(index);
+    }
+
+    void erase(Id id)
+    {
+        auto pageIndex = getPageIndex(id);
+        if (pageIndex >= m_pages.size() || !m_pages[pageIndex])
+            return;
+
+        auto &page = m_pages[pageIndex];
+        auto &value = page->values[getOffset(id)];
+        if (value == EMPTY)
+            return;
+
+        value = EMPTY;
+        if (--page->count == 0)
+            page.reset();
+    }
+
+    void clear()
+    {
+        m_pages.clear();
+    }
+
+    /**
+     * @brief Make room in the page table for ids up to and including the id.  Pages are still allocated lazily
+     */
+    void reserve(Id maxId)
+    {
+        auto pageIndex = getPageIndex(maxId);
+        if (pageIndex >= m_pages.size())
+            m_pages.resize(pageIndex + 1);
+    }
+
+    /**
+     * @brief Get the number of currently allocated pages
+     */
+    [[nodiscard]] size_t pageCount() const
+    {
+        return std::count_if(m_pages.begin(), m_pages.end(), [](const auto &page) { return !!page; });
+    }
+
+    /**
+     * @brief Get the number of bytes used by the page table and allocated pages
+     */
+    [[nodiscard]] size_t memoryUsage() const
+    {
+        return m_pages.capacity() * sizeof(std::unique_ptr<Page>) + pageCount() * sizeof(Page);
+    }
+
+  private:
+    // Dense indexes are stored as 32 bits to keep pages small
+    static constexpr uint32_t EMPTY = std::numeric_limits<uint32_t>::max();
+
+    struct Page
+    {
+        std::array<uint32_t, SPARSE_PAGE_SIZE> values;
+        size_t count{};
+    };
+
+    static_assert((SPARSE_PAGE_SIZE & (SPARSE_PAGE_SIZE - 1)) == 0, "Sparse page size must be a power of two");
+
+    [[nodiscard]] static size_t getPageIndex(Id id)
+    {
+        return static_cast<size_t>(id) / SPARSE_PAGE_SIZE;
+    }
+
+    [[nodiscard]] static size_t getOffset(Id id)
+    {
+        return static_cast<size_t>(id) & (SPARSE_PAGE_SIZE - 1);
+    }
+
+    std::vector<std::unique_ptr<Page>> m_pages{};
+};
+}; // namespace internal
+}; // namespace ECS
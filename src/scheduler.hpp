@@ -0,0 +1,308 @@
+#pragma once
+
+#include "command_buffer.hpp"
+#include "core.hpp"
+#include "entity_component_manager.hpp"
+#include "macros.hpp"
+#include "thread_pool.hpp"
+#include "utilities.hpp"
+
+namespace ECS
+{
+namespace internal
+{
+
+/**
+ * @brief Declares that a system reads the components of the types
+ */
+template <typename... Ts> struct Read
+{
+};
+
+/**
+ * @brief Declares that a system mutates the components of the types
+ */
+template <typename... Ts> struct Write
+{
+};
+
+/**
+ * @brief Runs systems each frame, running the ones whose declared component access does not conflict at once
+ *
+ * Systems are registered with the component types they read and write.  Each frame, a system depends on every
+ * earlier registered system which writes a type it reads or writes, or reads a type it writes.  Systems run on
+ * the manager's thread pool as soon as the systems they depend on have finished, so conflicting systems
+ * always run in the order they were registered.
+ *
+ * Systems must not add or remove components through the manager, which would move the component sets under
+ * the other systems running at the same time.  Each system gets its own command buffer instead, and the
+ * buffers are applied in registration order at the next sync point.  The end of each frame is a sync point,
+ * and more can be added between systems.
+ *
+ * Systems reading the same type run at the same time, so they should only use read-only access to it, such as
+ * each on a const set or inspectEach on a group, which never prune.
+ */
+template <typename EntityId> class Scheduler
+{
+  private:
+    using Manager = EntityComponentManager<EntityId>;
+    using Commands = CommandBuffer<EntityId>;
+    using SystemFn = std::function<void(Manager &, Commands &)>;
+
+  public:
+    using SystemId = size_t;
+
+    explicit Scheduler(Manager &_manager) : m_manager(_manager)
+    {
+    }
+
+    /**
+     * @brief Register a system to run every frame, after the earlier systems that it conflicts with
+     *
+     * Component sets of the declared types are created up front, so the systems never create them while
+     * others are running.
+     *
+     * @tparam Access - Read<Ts...> and Write<Ts...> declarations of the component types the system uses
+     *
+     * @param Function which accepts the manager and the system's command buffer
+     *
+     * @return Id of the system
+     */
+    template <typename... Access, typename Func> SystemId addSystem(Func &&fn)
+    {
+        System system;
+        system.fn = std::forward<Func>(fn);
+        system.commands = std::make_unique<Commands>(m_manager, &m_entityMutex);
+        system.phase = m_phaseCount;
+        (declare(system, static_cast<Access *>(nullptr)), ...);
+
+        std::sort(system.reads.begin(), system.reads.end());
+        std::sort(system.writes.begin(), system.writes.end());
+
+        m_systems.push_back(std::move(system));
+        return m_systems.size() - 1;
+    }
+
+    /**
+     * @brief Apply the command buffers of the systems registered so far before running any registered after
+     */
+    void addSyncPoint()
+    {
+        ++m_phaseCount;
+    }
+
+    /**
+     * @brief Enable or disable a system, starting from the next frame
+     *
+     * @param Id of the system
+     * @param Bool - false to skip the system
+     */
+    void setEnabled(SystemId systemId, bool isEnabled)
+    {
+        m_systems[systemId].isEnabled = isEnabled;
+    }
+
+    /**
+     * @brief Get the number of registered systems
+     */
+    [[nodiscard]] size_t size() const
+    {
+        return m_systems.size();
+    }
+
+    /**
+     * @brief Run every enabled system once, applying their commands at each sync point
+     *
+     * The first exception thrown by a system is rethrown once the rest of the systems before the next sync
+     * point have finished.  Commands which those systems recorded are dropped.
+     */
+    void run()
+    {
+        for (size_t begin = 0; begin < m_systems.size();)
+        {
+            auto end = begin;
+            while (end < m_systems.size() && m_systems[end].phase == m_systems[begin].phase)
+                ++end;
+
+            runPhase(begin, end);
+
+            if (m_exception)
+            {
+                for (auto &system : m_systems)
+                    system.commands->clear();
+
+                std::rethrow_exception(std::exchange(m_exception, nullptr));
+            }
+
+            for (auto i = begin; i < end; ++i)
+                m_systems[i].commands->apply();
+
+            begin = end;
+        }
+    }
+
+    Scheduler(const Scheduler &) = delete;
+    Scheduler &operator=(const Scheduler &) = delete;
+
+  private:
+    struct System
+    {
+        SystemFn fn{};
+        std::unique_ptr<Commands> commands{};
+
+        // Sorted component type ids
+        std::vector<size_t> reads{};
+        std::vector<size_t> writes{};
+
+        size_t phase{};
+        bool isEnabled{true};
+    };
+
+    template <typename... Ts> void declare(System &system, Read<Ts...> *)
+    {
+        (system.reads.push_back(Utilities::getTypeId<Ts>()), ...);
+        if constexpr (sizeof...(Ts) > 0)
+            (void)m_manager.template getAll<Ts...>();
+    }
+
+    template <typename... Ts> void declare(System &system, Write<Ts...> *)
+    {
+        (system.writes.push_back(Utilities::getTypeId<Ts>()), ...);
+        if constexpr (sizeof...(Ts) > 0)
+            (void)m_manager.template getAll<Ts...>();
+    }
+
+    [[nodiscard]] static bool intersects(const std::vector<size_t> &first, const std::vector<size_t> &second)
+    {
+        auto i = first.begin();
+        auto j = second.begin();
+        while (i != first.end() && j != second.end())
+        {
+            if (*i == *j)
+                return true;
+
+            *i < *j ? ++i : ++j;
+        }
+
+        return false;
+    }
+
+    [[nodiscard]] static bool conflicts(const System &first, const System &second)
+    {
+        return intersects(first.writes, second.writes) || intersects(first.writes, second.reads) ||
+               intersects(first.reads, second.writes);
+    }
+
+    /**
+     * @brief Build the dependencies between the enabled systems in [begin, end) and run them
+     */
+    void runPhase(size_t begin, size_t end)
+    {
+        m_frame.clear();
+        for (auto i = begin; i < end; ++i)
+        {
+            if (m_systems[i].isEnabled)
+                m_frame.push_back(i);
+        }
+
+        auto &pool = m_manager.getThreadPool();
+        if (m_frame.size() <= 1 || pool.size() == 1)
+        {
+            // Registration order already satisfies every dependency
+            for (const auto &systemIndex : m_frame)
+                runSystem(systemIndex);
+
+            return;
+        }
+
+        m_dependents.resize(m_frame.size());
+        m_pending.assign(m_frame.size(), 0);
+        m_ready.clear();
+        m_finished = 0;
+
+        for (size_t j = 0; j < m_frame.size(); ++j)
+        {
+            m_dependents[j].clear();
+            for (size_t i = 0; i < j; ++i)
+            {
+                if (!conflicts(m_systems[m_frame[i]], m_systems[m_frame[j]]))
+                    continue;
+
+                m_dependents[i].push_back(j);
+                ++m_pending[j];
+            }
+
+            if (!m_pending[j])
+                m_ready.push_back(j);
+        }
+
+        auto threadCount = std::min(pool.size(), m_frame.size());
+        pool.parallelFor(threadCount, 1, [&](size_t, size_t) { runReadySystems(); });
+    }
+
+    /**
+     * @brief Keep running whichever systems are ready until every system of the frame has finished
+     */
+    void runReadySystems()
+    {
+        std::unique_lock lock(m_frameMutex);
+        while (true)
+        {
+            m_frameChanged.wait(lock, [&]() { return !m_ready.empty() || m_finished == m_frame.size(); });
+            if (m_finished == m_frame.size())
+                return;
+
+            auto node = m_ready.front();
+            m_ready.pop_front();
+
+            lock.unlock();
+            runSystem(m_frame[node]);
+            lock.lock();
+
+            ++m_finished;
+            for (const auto &dependent : m_dependents[node])
+            {
+                if (--m_pending[dependent] == 0)
+                    m_ready.push_back(dependent);
+            }
+
+            m_frameChanged.notify_all();
+        }
+    }
+
+    void runSystem(size_t systemIndex)
+    {
+        auto &system = m_systems[systemIndex];
+        try
+        {
+            system.fn(m_manager, *system.commands);
+        }
+        catch (...)
+        {
+            std::lock_guard lock(m_exceptionMutex);
+            if (!m_exception)
+                m_exception = std::current_exception();
+        }
+    }
+
+    Manager &m_manager;
+    std::vector<System> m_systems{};
+    size_t m_phaseCount{};
+
+    // Guards entity creation by the systems' command buffers
+    std::mutex m_entityMutex{};
+
+    // State of the frame being run, kept between frames so its storage is reused
+    std::vector<size_t> m_frame{};
+    std::vector<std::vector<size_t>> m_dependents{};
+    std::vector<size_t> m_pending{};
+    std::deque<size_t> m_ready{};
+    size_t m_finished{};
+    std::mutex m_frameMutex{};
+    std::condition_variable m_frameChanged{};
+
+    std::mutex m_exceptionMutex{};
+    std::exception_ptr m_exception{};
+};
+}; // namespace internal
+}; // namespace ECS
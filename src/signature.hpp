@@ -0,0 +1,118 @@
+#pragma once
+
+#include "core.hpp"
+#include "entity.hpp"
+#include "macros.hpp"
+
+namespace ECS
+{
+namespace internal
+{
+
+/**
+ * @brief Per-entity bitsets of the component type ids each entity owns
+ *
+ * Every entity index gets the same number of 64-bit words, stored back to back in a single vector.  The number
+ * of words grows as component sets with higher type ids are registered.
+ */
+template <typename EntityId> class EntitySignatures
+{
+  public:
+    /**
+     * @brief Make room for component type ids up to, but not including, the count
+     */
+    void reserveComponents(size_t componentCount)
+    {
+        auto stride = (componentCount + WORD_BITS - 1) / WORD_BITS;
+        if (stride <= m_stride)
+            return;
+
+        std::vector<uint64_t> words(entityCount() * stride, 0);
+        for (size_t index = 0; index < entityCount(); ++index)
+            std::copy_n(m_words.begin() + index * m_stride, m_stride, words.begin() + index * stride);
+
+        m_words = std::move(words);
+        m_stride = stride;
+    }
+
+    /**
+     * @brief Make room for entity indexes up to and including the id's index
+     */
+    void reserveEntities(EntityId maxId)
+    {
+        auto index = Entity::getIndex(maxId);
+        if (index >= entityCount())
+            m_words.resize((index + 1) * m_stride, 0);
+    }
+
+    void set(EntityId eId, size_t componentId)
+    {
+        ECS_ASSERT(componentId < m_stride * WORD_BITS, "Component id has no room in the entity signature")
+
+        auto index = Entity::getIndex(eId);
+        if (index >= entityCount())
+            m_words.resize((index + 1) * m_stride, 0);
+
+        getWord(index, componentId) |= getBit(componentId);
+    }
+
+    void reset(EntityId eId, size_t componentId)
+    {
+        auto index = Entity::getIndex(eId);
+        if (index >= entityCount() || componentId >= m_stride * WORD_BITS)
+            return;
+
+        getWord(index, componentId) &= ~getBit(componentId);
+    }
+
+    [[nodiscard]] bool test(EntityId eId, size_t componentId) const
+    {
+        auto index = Entity::getIndex(eId);
+        if (index >= entityCount() || componentId >= m_stride * WORD_BITS)
+            return false;
+
+        return m_words[index * m_stride + componentId / WORD_BITS] & getBit(componentId);
+    }
+
+    /**
+     * @brief Call the function with every component type id in the entity's signature
+     *
+     * Each word is copied before its bits are visited, so the function may reset bits of the signature.
+     */
+    template <typename Func> void each(EntityId eId, Func &&fn) const
+    {
+        auto index = Entity::getIndex(eId);
+        if (index >= entityCount())
+            return;
+
+        for (size_t wordIndex = 0; wordIndex < m_stride; ++wordIndex)
+        {
+            for (uint64_t word = m_words[index * m_stride + wordIndex]; word; word &= word - 1)
+                fn(wordIndex * WORD_BITS + std::countr_zero(word));
+        }
+    }
+
+  private:
+    using Entity = EntityTraits<EntityId>;
+    static constexpr size_t WORD_BITS = 64;
+
+    [[nodiscard]] size_t entityCount() const
+    {
+        return m_stride ? m_words.size() / m_stride : 0;
+    }
+
+    [[nodiscard]] uint64_t &getWord(size_t index, size_t componentId)
+    {
+        return m_words[index * m_stride + componentId / WORD_BITS];
+    }
+
+    [[nodiscard]] static uint64_t getBit(size_t componentId)
+    {
+        return uint64_t{1} << (componentId % WORD_BITS);
+    }
+
+    size_t m_stride{};
+    std::vector<uint64_t> m_words{};
+};
+}; // namespace internal
+}; // namespace ECS
@@ -1,8 +1,12 @@
 #pragma once
 
 #include "base_sparse_set.hpp"
+#include "component_storage.hpp"
 #include "components.hpp"
+#include "entity.hpp"
 #include "macros.hpp"
+#include "paged_sparse_array.hpp"
+#include "thread_pool.hpp"
 #include "utilities.hpp"
 
 namespace ECS
@@ -11,6 +15,9 @@ namespace internal
 {
 /**
  * @brief A sparse set for storing components of the same type.
+ *
+ * Components are kept in dense storage alongside their entity ids.  Each loops and lookups hand out a
+ * components wrapper, which is a view over the entity's slot in that storage.
  */
 template <typename Id, typename T>
 class SparseSet : public BaseSparseSet<Id, ComponentsWrapper<DefaultComponent>>
@@ -18,14 +25,30 @@ class SparseSet : public BaseSparseSet<Id, ComponentsWrapper<DefaultComponent>>
   public:
     template <typename EntityId> friend class EntityComponentManager;
     template <typename EntityId, typename... Ts> friend class Grouping;
+    template <typename EntityId> friend class CommandBuffer;
+    template <typename EntityId, typename... Ts> friend class OwningGrouping;
+    template <typename EntityId, typename... Ts> friend class CachedQuery;
 
-    explicit SparseSet(size_t _initialSize, size_t _resize) : m_resize(_resize)
+    using Component = T;
+    using Components = ComponentsWrapper<T>;
+
+    static constexpr size_t DEFAULT_CHUNK_SIZE = 4096;
+
+    explicit SparseSet(size_t _initialSize)
     {
-        m_pointers.resize(_initialSize, -1);
-        m_values.reserve(_initialSize);
+        m_storage.reserve(_initialSize);
         m_ids.reserve(_initialSize);
     }
 
+    ~SparseSet() override
+    {
+        if (!this->m_signatures)
+            return;
+
+        for (const auto &id : m_ids)
+            this->m_signatures->reset(id, this->m_componentId);
+    }
+
     explicit operator bool() const
     {
         return size() > 0;
@@ -40,6 +63,14 @@ class SparseSet : public BaseSparseSet<Id, ComponentsWrapper<DefaultComponent>>
         return m_ids;
     }
 
+    /**
+     * @brief Get the ids without pruning, so ids whose components were all removed may still be included
+     */
+    [[nodiscard]] const std::vector<Id> &getIds() const
+    {
+        return m_ids;
+    }
+
     /**
      * @brief Basic each loop
      *
@@ -52,35 +83,257 @@ class SparseSet : public BaseSparseSet<Id, ComponentsWrapper<DefaultComponent>>
      */
     template <typename Func> void each(Func &&func)
     {
-        static_assert(std::is_invocable_v<Func, Id, T &>, "Each function must take T& as argument.");
+        static_assert(std::is_invocable_v<Func, Id, Components &>,
+                      "Each function must take Components<T>& as argument.");
 
-        if constexpr (Utilities::ReturnsBool<Func, Id, T &>)
+        if constexpr (Utilities::ReturnsBool<Func, Id, Components &>)
             eachWithBreak(func);
         else
             eachNoBreak(func);
     }
 
+    /**
+     * @brief Read-only each loop
+     *
+     * The function argument can optionally return a bool to determine the loop-breaking behavior.
+     * A false return value is a break.
+     *
+     * Empty values are skipped but never pruned, and the components are passed as a const wrapper, so loops
+     * over the same set can safely run at the same time.  Pruning is left to an explicit call to prune.
+     *
+     * @param Function
+     */
+    template <typename Func> void each(Func &&func) const
+    {
+        static_assert(std::is_invocable_v<Func, Id, const Components &>,
+                      "Each function must take const Components<T>& as argument.");
+
+        auto storage = const_cast<ComponentStorage<T> *>(&m_storage);
+        for (size_t i = 0; i < m_ids.size(); ++i)
+        {
+            if (m_storage.isEmpty(i))
+                continue;
+
+            const Components comps(storage, i);
+            if constexpr (Utilities::ReturnsBool<Func, Id, const Components &>)
+            {
+                if (!func(m_ids[i], comps))
+                    break;
+            }
+            else
+                func(m_ids[i], comps);
+        }
+    }
+
+    /**
+     * @brief Each loop over only the ids whose components changed at or after the tick
+     *
+     * Components count as changed when they are added, overwritten, mutated, or handed out by eachChunk.
+     * The function argument can optionally return a bool to determine the loop-breaking behavior.
+     * A false return value is a break.
+     *
+     * Only the change ticks are scanned for the ids which are skipped, so a pass over a few changes in a large
+     * set costs far less than a full each loop.  Empty values are skipped but never pruned.
+     *
+     * @param Tick of the manager's frame counter
+     * @param Function
+     */
+    template <typename Func> void eachChangedSince(ChangeTick tick, Func &&func)
+    {
+        static_assert(std::is_invocable_v<Func, Id, Components &>,
+                      "Each function must take Components<T>& as argument.");
+
+        for (size_t i = 0; i < m_ids.size(); ++i)
+        {
+            if (m_storage.getChangeTick(i) < tick || m_storage.isEmpty(i))
+                continue;
+
+            Components comps(&m_storage, i);
+            if constexpr (Utilities::ReturnsBool<Func, Id, Components &>)
+            {
+                if (!func(m_ids[i], comps))
+                    break;
+            }
+            else
+                func(m_ids[i], comps);
+        }
+    }
+
+    /**
+     * @brief Read-only each loop over only the ids whose components changed at or after the tick
+     *
+     * @param Tick of the manager's frame counter
+     * @param Function
+     */
+    template <typename Func> void eachChangedSince(ChangeTick tick, Func &&func) const
+    {
+        static_assert(std::is_invocable_v<Func, Id, const Components &>,
+                      "Each function must take const Components<T>& as argument.");
+
+        auto storage = const_cast<ComponentStorage<T> *>(&m_storage);
+        for (size_t i = 0; i < m_ids.size(); ++i)
+        {
+            if (m_storage.getChangeTick(i) < tick || m_storage.isEmpty(i))
+                continue;
+
+            const Components comps(storage, i);
+            if constexpr (Utilities::ReturnsBool<Func, Id, const Components &>)
+            {
+                if (!func(m_ids[i], comps))
+                    break;
+            }
+            else
+                func(m_ids[i], comps);
+        }
+    }
+
+    /**
+     * @brief NON-STACKED COMPONENT ONLY! Iterate over the raw components in contiguous chunks
+     *
+     * The function is passed matching spans of ids and components, which cover the dense storage in order and
+     * skip empty values without pruning them.  Components are passed as stored, without applying the set's
+     * transformation pipeline, so loops can be vectorized across entities.
+     *
+     * The function argument can optionally return a bool to determine the loop-breaking behavior.
+     * A false return value is a break.
+     *
+     * @param Function which accepts std::span<const Id> and std::span<T>
+     * @param Maximum number of components per chunk
+     */
+    template <typename Func>
+    void eachChunk(Func &&func, size_t chunkSize = DEFAULT_CHUNK_SIZE)
+        requires(!ComponentStorage<T>::isStacked)
+    {
+        static_assert(std::is_invocable_v<Func, std::span<const Id>, std::span<T>>,
+                      "Chunk function must take std::span<const Id> and std::span<T> as arguments.");
+
+        // Chunks are handed out for writing, so each one counts as changed
+        auto isSkipped = [&](size_t i) { return m_storage.isEmpty(i); };
+        Utilities::forEachRun(m_ids.size(), chunkSize, isSkipped, [&](size_t begin, size_t end) {
+            m_storage.markChanged(begin, end);
+            return func(std::span<const Id>(m_ids.data() + begin, end - begin),
+                        std::span<T>(m_storage.data(begin), end - begin));
+        });
+    }
+
+    /**
+     * @brief NON-STACKED COMPONENT ONLY! Read-only iteration over the raw components in contiguous chunks
+     *
+     * @param Function which accepts std::span<const Id> and std::span<const T>
+     * @param Maximum number of components per chunk
+     */
+    template <typename Func>
+    void eachChunk(Func &&func, size_t chunkSize = DEFAULT_CHUNK_SIZE) const
+        requires(!ComponentStorage<T>::isStacked)
+    {
+        static_assert(std::is_invocable_v<Func, std::span<const Id>, std::span<const T>>,
+                      "Chunk function must take std::span<const Id> and std::span<const T> as arguments.");
+
+        auto isSkipped = [&](size_t i) { return m_storage.isEmpty(i); };
+        Utilities::forEachRun(m_ids.size(), chunkSize, isSkipped, [&](size_t begin, size_t end) {
+            return func(std::span<const Id>(m_ids.data() + begin, end - begin),
+                        std::span<const T>(m_storage.data(begin), end - begin));
+        });
+    }
+
+    /**
+     * @brief Erase the ids whose components have all been removed
+     */
+    void prune() override
+    {
+        for (auto i = 0; i < m_ids.size();)
+        {
+            if (m_storage.isEmpty(i))
+            {
+                erase(m_ids[i]);
+                continue;
+            }
+
+            ++i;
+        }
+    }
+
+    /**
+     * @brief Each loop split into chunks of the dense range, which run on the threads of the pool
+     *
+     * The function is called concurrently, so it may only read and mutate the components it is passed.
+     * Adding, removing, or mutating the components of any other entity during the call is not allowed.  Loops
+     * can not be broken out of, and empty values are skipped, then pruned once every chunk has finished.
+     *
+     * @param Thread pool to run the chunks on
+     * @param Function
+     * @param Number of dense entries per chunk
+     */
+    template <typename Func>
+    void parallelEach(ThreadPool &pool, Func &&func, size_t chunkSize = ThreadPool::DEFAULT_CHUNK_SIZE)
+    {
+        static_assert(std::is_invocable_v<Func, Id, Components &>,
+                      "Each function must take Components<T>& as argument.");
+        static_assert(!Utilities::ReturnsBool<Func, Id, Components &>, "Parallel each loops can not break.");
+
+        {
+            ParallelIterationGuard guard(this);
+            pool.parallelFor(m_ids.size(), chunkSize, [&](size_t begin, size_t end) {
+                for (auto i = begin; i < end; ++i)
+                {
+                    if (m_storage.isEmpty(i))
+                        continue;
+
+                    Components comps(&m_storage, i);
+                    func(m_ids[i], comps);
+                }
+            });
+        }
+
+#ifndef ecs_disable_auto_prune
+        prune();
+#endif
+    }
+
     SparseSet(const SparseSet &) = delete;
     SparseSet &operator=(const SparseSet &) = delete;
 
   private:
+    /**
+     * @brief Marks the set as being iterated in parallel for as long as it lives
+     */
+    struct ParallelIterationGuard
+    {
+        explicit ParallelIterationGuard(SparseSet *_set) : set(_set)
+        {
+            if (set)
+                ++set->m_parallelIterations;
+        }
+
+        ~ParallelIterationGuard()
+        {
+            if (set)
+                --set->m_parallelIterations;
+        }
+
+        ParallelIterationGuard(const ParallelIterationGuard &) = delete;
+        ParallelIterationGuard &operator=(const ParallelIterationGuard &) = delete;
+
+        SparseSet *set;
+    };
+
     template <typename Func> void eachNoBreak(Func &&func)
     {
         for (auto i = 0; i < m_ids.size();)
         {
-            if (m_pointers[m_ids[i]] != -1)
+            if (!m_storage.isEmpty(i))
             {
-                if (m_values[i])
-                    func(m_ids[i], m_values[i]);
+                Components comps(&m_storage, i);
+                func(m_ids[i], comps);
+            }
 
 #ifndef ecs_disable_auto_prune
-                if (!m_values[i])
-                {
-                    erase(m_ids[i]);
-                    continue;
-                }
-#endif
+            if (m_storage.isEmpty(i))
+            {
+                erase(m_ids[i]);
+                continue;
             }
+#endif
 
             ++i;
         }
@@ -89,19 +342,20 @@ class SparseSet : public BaseSparseSet<Id, ComponentsWrapper<DefaultComponent>>
     {
         for (auto i = 0; i < m_ids.size();)
         {
-            if (m_pointers[m_ids[i]] != -1)
+            if (!m_storage.isEmpty(i))
             {
-                if (m_values[i] && !func(m_ids[i], m_values[i]))
+                Components comps(&m_storage, i);
+                if (!func(m_ids[i], comps))
                     break;
+            }
 
 #ifndef ecs_disable_auto_prune
-                if (!m_values[i])
-                {
-                    erase(m_ids[i]);
-                    continue;
-                }
-#endif
+            if (m_storage.isEmpty(i))
+            {
+                erase(m_ids[i]);
+                continue;
             }
+#endif
 
             ++i;
         }
@@ -110,21 +364,32 @@ class SparseSet : public BaseSparseSet<Id, ComponentsWrapper<DefaultComponent>>
     template <typename Func> void eachWithEmpty(Func &&func)
     {
         for (auto i = 0; i < m_ids.size(); ++i)
-            if (m_pointers[m_ids[i]] != -1)
-                func(m_ids[i], m_values[i]);
+        {
+            Components comps(&m_storage, i);
+            func(m_ids[i], comps);
+        }
     }
 
-    [[nodiscard]] T *get(Id id)
+    /**
+     * @brief Get a view of the id's components, which is empty if the id is not stored
+     */
+    [[nodiscard]] Components get(Id id)
     {
-        return contains(id) ? &(m_values[m_pointers[id]]) : nullptr;
+        auto index = getDenseIndex(id);
+        return index != npos ? Components(&m_storage, index) : Components();
     }
 
-    [[nodiscard]] std::pair<Id, T *> getFirst()
+    [[nodiscard]] Components getByDenseIndex(size_t index)
+    {
+        return Components(&m_storage, index);
+    }
+
+    [[nodiscard]] std::pair<Id, Components> getFirst()
     {
         if (m_ids.empty())
-            return {0, nullptr};
+            return {0, Components()};
 
-        return {m_ids[0], &m_values[0]};
+        return {m_ids[0], Components(&m_storage, 0)};
     }
 
     void lock()
@@ -142,8 +407,21 @@ class SparseSet : public BaseSparseSet<Id, ComponentsWrapper<DefaultComponent>>
         return m_isLocked;
     }
 
+    /**
+     * @brief Check whether the set is being iterated in parallel, during which structural changes are refused
+     */
+    [[nodiscard]] bool isIteratedInParallel() const
+    {
+        return m_parallelIterations != 0;
+    }
+
     void insert(Id id, T value)
     {
+        if (isIteratedInParallel())
+        {
+            ECS_LOG_WARNING(typeid(T).name(), "is iterated in parallel.  Cannot add to it");
+            return;
+        }
         if (isLocked())
         {
             ECS_LOG_WARNING(typeid(T).name(), "is locked.  Cannot add to it");
@@ -154,78 +432,362 @@ class SparseSet : public BaseSparseSet<Id, ComponentsWrapper<DefaultComponent>>
             ECS_LOG_WARNING(id, "Already contains", typeid(T).name(), "Add failed");
             return;
         }
-
-        while (id >= m_pointers.size())
+        if (isOccupied(id))
         {
-            auto pSize = m_pointers.size();
-            auto newSize = pSize > 0 ? pSize + (pSize / 2) : m_resize;
-            m_pointers.resize(newSize, -1);
-            m_values.reserve(newSize);
-            m_ids.reserve(newSize);
+            ECS_LOG_WARNING(id, "is a stale entity id for", typeid(T).name(), "Add failed");
+            return;
         }
 
-        m_pointers[id] = m_ids.size();
+        m_pointers.insert(Entity::getIndex(id), m_ids.size());
+        if (this->m_signatures)
+            this->m_signatures->set(id, this->m_componentId);
+
         // TODO Performance : See if using a pair to store id with component is better
         m_ids.push_back(id);
-        m_values.push_back(std::move(value));
+        m_storage.emplace(std::move(value));
+
+        this->notifyInsert(id);
     }
 
-    template <typename... Args> T *emplace(Id id, Args... args)
+    template <typename... Args> bool emplace(Id id, Args &&...args)
     {
+        if (isIteratedInParallel())
+        {
+            ECS_LOG_WARNING(typeid(T).name(), "is iterated in parallel.  Cannot add to it");
+            return false;
+        }
         if (isLocked())
         {
             ECS_LOG_WARNING(typeid(T).name(), "is locked.  Cannot add to it");
-            return nullptr;
+            return false;
         }
         if (contains(id))
         {
             ECS_LOG_WARNING(id, "Already contains", typeid(T).name(), "Add failed");
-            return nullptr;
+            return false;
         }
+        if (isOccupied(id))
+        {
+            ECS_LOG_WARNING(id, "is a stale entity id for", typeid(T).name(), "Add failed");
+            return false;
+        }
+
+        m_pointers.insert(Entity::getIndex(id), m_ids.size());
+        if (this->m_signatures)
+            this->m_signatures->set(id, this->m_componentId);
+
+        m_ids.push_back(id);
+        m_storage.emplace(std::forward<Args>(args)...);
+
+        this->notifyInsert(id);
 
-        while (id >= m_pointers.size())
+        return true;
+    }
+
+    /**
+     * @brief Add a component for an id which is expected to not be stored, such as an id which was just created
+     *
+     * A single lookup of the index refuses both the id and any other generation of it, rather than the separate
+     * checks which emplace makes.
+     */
+    template <typename... Args> void emplaceNew(Id id, Args &&...args)
+    {
+        if (isIteratedInParallel())
         {
-            auto pSize = m_pointers.size();
-            auto newSize = pSize > 0 ? pSize + (pSize / 2) : m_resize;
-            m_pointers.resize(newSize, -1);
-            m_values.reserve(newSize);
-            m_ids.reserve(newSize);
+            ECS_LOG_WARNING(typeid(T).name(), "is iterated in parallel.  Cannot add to it");
+            return;
         }
+        if (isLocked())
+        {
+            ECS_LOG_WARNING(typeid(T).name(), "is locked.  Cannot add to it");
+            return;
+        }
+        if (isOccupied(id))
+        {
+            ECS_LOG_WARNING(id, "or another generation of it is already stored in", typeid(T).name(), "Add failed");
+            return;
+        }
+
+        m_pointers.insert(Entity::getIndex(id), m_ids.size());
+        if (this->m_signatures)
+            this->m_signatures->set(id, this->m_componentId);
 
-        m_pointers[id] = m_ids.size();
         m_ids.push_back(id);
-        return &m_values.emplace_back(args...);
+        m_storage.emplace(std::forward<Args>(args)...);
+
+        this->notifyInsert(id);
+    }
+
+    /**
+     * @brief Add a component to each of the ids, constructing each of them from the function's return value
+     *
+     * The lock is checked and the dense arrays, sparse pages, and signatures are grown once for every id,
+     * rather than once per id.  Ids which are already stored get the component added to their stack instead,
+     * as with emplaceInto.
+     *
+     * @param Entity ids
+     * @param Function which accepts the position of the id in the span and returns the component
+     *
+     * @return Number of ids which were added to
+     */
+    template <typename Func> size_t emplaceBulk(std::span<const Id> ids, Func &&makeComponent)
+    {
+        if (isIteratedInParallel())
+        {
+            ECS_LOG_WARNING(typeid(T).name(), "is iterated in parallel.  Cannot add to it");
+            return 0;
+        }
+        if (isLocked())
+        {
+            ECS_LOG_WARNING(typeid(T).name(), "is locked.  Cannot add to it");
+            return 0;
+        }
+        if (ids.empty())
+            return 0;
+
+        // Grows geometrically, so repeated small bulk adds do not reallocate every time
+        auto required = m_ids.size() + ids.size();
+        if (required > m_ids.capacity())
+            reserve(std::max(required, m_ids.capacity() * 2));
+
+        auto maxId = *std::max_element(ids.begin(), ids.end(), [](const Id &first, const Id &second) {
+            return Entity::getIndex(first) < Entity::getIndex(second);
+        });
+        m_pointers.reserve(Entity::getIndex(maxId));
+        if (this->m_signatures)
+            this->m_signatures->reserveEntities(maxId);
+
+        size_t added{};
+        for (size_t i = 0; i < ids.size(); ++i)
+        {
+            const auto &id = ids[i];
+            if (auto index = getDenseIndex(id); index != npos)
+            {
+                if (m_storage.emplaceInto(index, makeComponent(i)))
+                    ++added;
+                else
+                    ECS_LOG_WARNING(id, "Already contains a NoStack-tagged ", Utilities::getTypeName<T>(),
+                                    "Add failed!");
+                continue;
+            }
+            if (isOccupied(id))
+            {
+                ECS_LOG_WARNING(id, "is a stale entity id for", typeid(T).name(), "Add failed");
+                continue;
+            }
+
+            m_pointers.insert(Entity::getIndex(id), m_ids.size());
+            if (this->m_signatures)
+                this->m_signatures->set(id, this->m_componentId);
+
+            m_ids.push_back(id);
+            m_storage.emplace(makeComponent(i));
+            ++added;
+
+            this->notifyInsert(id);
+        }
+
+        return added;
+    }
+
+    /**
+     * @brief Add a copy of the source id's components to each of the ids
+     *
+     * The copies are appended in a single pass over the storage.  Ids whose index is already stored, directly or
+     * through another generation, are skipped with a warning.  Unique components are never cloned.
+     *
+     * @param Id to copy the components of
+     * @param Ids to add the copies to
+     */
+    void clone(Id source, std::span<const Id> ids) override
+    {
+        if (isIteratedInParallel())
+        {
+            ECS_LOG_WARNING(typeid(T).name(), "is iterated in parallel.  Cannot add to it");
+            return;
+        }
+        if constexpr (Utilities::isUnique<T>())
+        {
+            ECS_LOG_WARNING(typeid(T).name(), "is unique.  Cannot clone it");
+            return;
+        }
+
+        auto index = getDenseIndex(source);
+        if (index == npos || m_storage.isEmpty(index) || ids.empty())
+            return;
+
+        if (isLocked())
+        {
+            ECS_LOG_WARNING(typeid(T).name(), "is locked.  Cannot add to it");
+            return;
+        }
+
+        auto required = m_ids.size() + ids.size();
+        if (required > m_ids.capacity())
+            reserve(std::max(required, m_ids.capacity() * 2));
+
+        // Every target is checked before the storage grows, so refused ids never leave a copy behind
+        std::vector<Id> added;
+        added.reserve(ids.size());
+        for (const auto &id : ids)
+        {
+            if (isOccupied(id))
+            {
+                ECS_LOG_WARNING(id, "or another generation of it is already stored in", typeid(T).name(),
+                                "Clone failed");
+                continue;
+            }
+
+            m_pointers.insert(Entity::getIndex(id), m_ids.size());
+            if (this->m_signatures)
+                this->m_signatures->set(id, this->m_componentId);
+
+            m_ids.push_back(id);
+            added.push_back(id);
+        }
+
+        if (added.empty())
+            return;
+
+        m_storage.appendCopies(index, added.size());
+
+        // Observers may reorder the dense arrays, so they are only told once every copy is in place
+        for (const auto &id : added)
+            this->notifyInsert(id);
+    }
+
+    /**
+     * @brief Reserve room in the dense arrays for the number of ids
+     */
+    void reserve(size_t size)
+    {
+        m_ids.reserve(size);
+        m_storage.reserve(size);
+    }
+
+    /**
+     * @brief Add a component to an id which is already stored
+     *
+     * @return Bool - false if the id already has a NoStack-tagged component
+     */
+    template <typename... Args> bool emplaceInto(Id id, Args &&...args)
+    {
+        if (isIteratedInParallel())
+        {
+            ECS_LOG_WARNING(typeid(T).name(), "is iterated in parallel.  Cannot add to it");
+            return false;
+        }
+        auto index = getDenseIndex(id);
+        if (index == npos)
+            return false;
+
+        return m_storage.emplaceInto(index, std::forward<Args>(args)...);
     }
 
     void overwrite(Id id, T value)
     {
-        if (!contains(id))
+        auto index = getDenseIndex(id);
+        if (index == npos)
         {
             ECS_LOG_WARNING(id, "does not contain", typeid(T).name(), "Overwrite failed");
             return;
         }
 
-        m_values[m_pointers[id]] = std::move(value);
+        m_storage.overwrite(index, std::move(value));
+        if (this->m_events)
+            this->m_events->overwritten.push_back(id);
+    }
+
+    /**
+     * @brief Read the tick to stamp changed components with from the source, which must outlive the set
+     */
+    void setTickSource(const ChangeTick *tickSource)
+    {
+        m_storage.setTickSource(tickSource);
+    }
+
+    /**
+     * @brief Set the transformation pipeline used by every component in the set, or null to remove it
+     */
+    void setTransformation(std::function<T(Id, T)> transformationFn)
+    {
+        m_transformation = std::move(transformationFn);
+        if (!m_transformation)
+        {
+            m_storage.setTransformation(nullptr, nullptr);
+            return;
+        }
+
+        m_storage.setTransformation(&transformAt, this);
+    }
+
+    /**
+     * @brief Transform the components of every entity whose cached result is stale, in dense order
+     *
+     * Transformed reads afterwards use the cached results until the components change.
+     */
+    void transformAll()
+    {
+        if (m_storage.hasTransformation())
+            m_storage.transformRange(0, m_ids.size());
+    }
+
+    /**
+     * @brief Transform the components of every entity whose cached result is stale, split into chunks of the
+     * dense range which run on the threads of the pool
+     *
+     * @param Thread pool to run the chunks on
+     * @param Number of dense entries per chunk
+     */
+    void parallelTransformAll(ThreadPool &pool, size_t chunkSize = ThreadPool::DEFAULT_CHUNK_SIZE)
+    {
+        if (!m_storage.hasTransformation())
+            return;
+
+        ParallelIterationGuard guard(this);
+        pool.parallelFor(m_ids.size(), chunkSize,
+                         [&](size_t begin, size_t end) { m_storage.transformRange(begin, end); });
+    }
+
+    /**
+     * @brief Mark the cached transformed components of every entity as stale
+     */
+    void invalidateTransformation()
+    {
+        m_storage.invalidateTransformed();
     }
 
     void erase(Id id1) override
     {
-        if (!contains(id1))
+        if (isIteratedInParallel())
+        {
+            ECS_LOG_WARNING(typeid(T).name(), "is iterated in parallel.  Cannot erase from it");
+            return;
+        }
+        auto valIndex = getDenseIndex(id1);
+        if (valIndex == npos)
             return;
 
-        auto valIndex = m_pointers[id1];
+        if (this->isObserved())
+        {
+            // The owner may move the id out of its partition
+            this->notifyErase(id1);
+            valIndex = getDenseIndex(id1);
+        }
+
         auto lastIndex = m_ids.size() - 1;
 
         auto lastId = m_ids[lastIndex];
 
-        std::swap(m_values[valIndex], m_values[lastIndex]);
-        m_values.pop_back();
+        m_storage.swapRemove(valIndex);
 
         std::swap(m_ids[valIndex], m_ids[lastIndex]);
         m_ids.pop_back();
 
-        m_pointers[lastId] = valIndex;
-        m_pointers[id1] = -1;
+        m_pointers.set(Entity::getIndex(lastId), valIndex);
+        m_pointers.erase(Entity::getIndex(id1));
+        if (this->m_signatures)
+            this->m_signatures->reset(id1, this->m_componentId);
     }
 
     template <typename... Ids> void erase(Id id, Ids... ids)
@@ -240,37 +802,103 @@ class SparseSet : public BaseSparseSet<Id, ComponentsWrapper<DefaultComponent>>
             erase(id);
     }
 
+    /**
+     * @brief Check for the id, rejecting stale ids whose index has since been recycled
+     */
     [[nodiscard]] bool contains(Id id)
     {
-        return id < m_pointers.size() && m_pointers[id] != -1;
+        return getDenseIndex(id) != npos;
     }
 
-    void prune() override
+    /**
+     * @brief Remove every id from the set
+     */
+    void clear() override
     {
-        for (auto i = 0; i < m_ids.size();)
+        if (isIteratedInParallel())
         {
-            if (m_pointers[m_ids[i]] != -1)
-            {
-                if (!m_values[i])
-                {
-                    erase(m_ids[i]);
-                    continue;
-                }
-            }
-
-            ++i;
+            ECS_LOG_WARNING(typeid(T).name(), "is iterated in parallel.  Cannot clear it");
+            return;
+        }
+        if (this->m_signatures)
+        {
+            for (const auto &id : m_ids)
+                this->m_signatures->reset(id, this->m_componentId);
         }
+
+        if (this->m_events)
+            this->m_events->removed.insert(this->m_events->removed.end(), m_ids.begin(), m_ids.end());
+
+        m_pointers.clear();
+        m_storage.clear();
+        m_ids.clear();
+
+        this->notifyClear();
+    }
+
+    /**
+     * @brief Exchange the positions of two ids in the dense arrays
+     */
+    void swapDense(size_t first, size_t second)
+    {
+        if (first == second)
+            return;
+
+        std::swap(m_ids[first], m_ids[second]);
+        m_storage.swap(first, second);
+        m_pointers.set(Entity::getIndex(m_ids[first]), first);
+        m_pointers.set(Entity::getIndex(m_ids[second]), second);
+    }
+
+    /**
+     * @brief Check for the id, and that its components have not all been removed
+     */
+    [[nodiscard]] bool hasComponents(Id id) const
+    {
+        auto index = getDenseIndex(id);
+        return index != npos && !m_storage.isEmpty(index);
     }
 
   private:
+    using Entity = EntityTraits<Id>;
+    static constexpr size_t npos = PagedSparseArray<Id>::npos;
+
+    [[nodiscard]] size_t getDenseIndex(Id id) const
+    {
+        auto index = m_pointers.get(Entity::getIndex(id));
+        if (index == npos || m_ids[index] != id)
+            return npos;
+
+        return index;
+    }
+
+    /**
+     * @brief Check whether any generation of the id's index is stored
+     */
+    [[nodiscard]] bool isOccupied(Id id) const
+    {
+        return m_pointers.contains(Entity::getIndex(id));
+    }
+
+    /**
+     * @brief Run the set's pipeline on the components of the storage slot, with the set as the context
+     */
+    static T transformAt(const void *context, size_t index, const T &component)
+    {
+        auto &cSet = *static_cast<const SparseSet *>(context);
+        return cSet.m_transformation(cSet.m_ids[index], component);
+    }
+
     using value_type = T;
-    size_t m_resize{};
     bool m_isLocked{false};
+    size_t m_parallelIterations{};
 
-    std::vector<size_t> m_pointers{};
-    std::vector<T> m_values{};
+    PagedSparseArray<Id> m_pointers{};
+    ComponentStorage<T> m_storage{};
     std::vector<Id> m_ids{};
 
+    std::function<T(Id, T)> m_transformation{};
+
 #ifdef ecs_allow_debug
   public:
 #else
@@ -280,6 +908,14 @@ class SparseSet : public BaseSparseSet<Id, ComponentsWrapper<DefaultComponent>>
     {
         return m_ids.size();
     }
+
+    /**
+     * @brief Get the number of bytes used by the sparse index
+     */
+    [[nodiscard]] size_t sparseMemoryUsage() const
+    {
+        return m_pointers.memoryUsage();
+    }
 };
 }; // namespace internal
 }; // namespace ECS
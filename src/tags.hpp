@@ -1,6 +1,5 @@
 #pragma once
 
-#include "components.hpp"
 #include "timer.hpp"
 #include "utilities.hpp"
 
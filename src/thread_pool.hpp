@@ -0,0 +1,258 @@
+#pragma once
+
+#include "core.hpp"
+#include "macros.hpp"
+
+namespace ECS
+{
+namespace internal
+{
+
+/**
+ * @brief A fixed set of worker threads which split index ranges between them
+ *
+ * A range is cut into chunks, and each thread is handed a contiguous run of them.  Threads work through their
+ * own chunks from the front, and once they run out, steal chunks from the back of the other threads' runs, so
+ * uneven chunks do not leave threads idle.  The calling thread takes part as the first thread, so a pool of a
+ * single thread has no workers and runs everything inline.
+ *
+ * Calls from several threads are serialised.  Calls made from inside a chunk run inline on the thread making
+ * them, rather than waiting on the pool they are already part of.
+ */
+class ThreadPool
+{
+  public:
+    static constexpr size_t DEFAULT_CHUNK_SIZE = 4096;
+
+    /**
+     * @param Number of threads, including the calling thread.  Defaults to the hardware concurrency
+     */
+    explicit ThreadPool(size_t threadCount = std::thread::hardware_concurrency())
+    {
+        threadCount = std::max<size_t>(threadCount, 1);
+        for (size_t i = 0; i < threadCount; ++i)
+            m_queues.push_back(std::make_unique<Queue>());
+
+        for (size_t i = 1; i < threadCount; ++i)
+            m_workers.emplace_back([this, i]() { work(i); });
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard lock(m_wakeMutex);
+            m_stop = true;
+        }
+
+        m_wake.notify_all();
+        for (auto &worker : m_workers)
+            worker.join();
+    }
+
+    /**
+     * @brief Get the number of threads, including the calling thread
+     */
+    [[nodiscard]] size_t size() const
+    {
+        return m_queues.size();
+    }
+
+    /**
+     * @brief Run the function over [0, count) in chunks, and wait for every chunk to finish
+     *
+     * The first exception thrown by a chunk is rethrown once every chunk has finished.
+     *
+     * @param Number of indexes
+     * @param Number of indexes per chunk
+     * @param Function which accepts the begin and end index of a chunk
+     */
+    template <typename Func> void parallelFor(size_t count, size_t chunkSize, Func &&fn)
+    {
+        if (!count)
+            return;
+
+        chunkSize = std::max<size_t>(chunkSize, 1);
+        auto chunkCount = (count + chunkSize - 1) / chunkSize;
+
+        if (chunkCount == 1 || size() == 1 || currentPool() == this)
+        {
+            fn(size_t{0}, count);
+            return;
+        }
+
+        std::lock_guard callLock(m_callMutex);
+
+        m_job.fn = const_cast<void *>(static_cast<const void *>(std::addressof(fn)));
+        m_job.invoke = [](void *fnPtr, size_t begin, size_t end) {
+            (*static_cast<std::remove_reference_t<Func> *>(fnPtr))(begin, end);
+        };
+        m_remaining = chunkCount;
+
+        for (size_t q = 0; q < size(); ++q)
+        {
+            auto &queue = *m_queues[q];
+            std::lock_guard lock(queue.mutex);
+            for (auto i = q * chunkCount / size(); i < (q + 1) * chunkCount / size(); ++i)
+                queue.chunks.push_back({i * chunkSize, std::min(count, (i + 1) * chunkSize)});
+        }
+
+        {
+            std::lock_guard lock(m_wakeMutex);
+            ++m_generation;
+        }
+        m_wake.notify_all();
+
+        {
+            CurrentPoolGuard guard(this);
+            runChunks(0);
+        }
+
+        {
+            std::unique_lock lock(m_doneMutex);
+            m_done.wait(lock, [&]() { return m_remaining.load() == 0; });
+        }
+
+        if (m_exception)
+            std::rethrow_exception(std::exchange(m_exception, nullptr));
+    }
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+  private:
+    struct Chunk
+    {
+        size_t begin{};
+        size_t end{};
+    };
+
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Chunk> chunks;
+    };
+
+    struct Job
+    {
+        void *fn{};
+        void (*invoke)(void *, size_t, size_t){};
+    };
+
+    static const ThreadPool *&currentPool()
+    {
+        thread_local const ThreadPool *pool{};
+        return pool;
+    }
+
+    /**
+     * @brief Marks the thread as running chunks of the pool, restoring the pool it was running before
+     */
+    struct CurrentPoolGuard
+    {
+        explicit CurrentPoolGuard(const ThreadPool *pool) : previous(std::exchange(currentPool(), pool))
+        {
+        }
+
+        ~CurrentPoolGuard()
+        {
+            currentPool() = previous;
+        }
+
+        CurrentPoolGuard(const CurrentPoolGuard &) = delete;
+        CurrentPoolGuard &operator=(const CurrentPoolGuard &) = delete;
+
+        const ThreadPool *previous;
+    };
+
+    void work(size_t index)
+    {
+        currentPool() = this;
+
+        size_t generation{};
+        while (true)
+        {
+            {
+                std::unique_lock lock(m_wakeMutex);
+                m_wake.wait(lock, [&]() { return m_stop || m_generation != generation; });
+                if (m_stop)
+                    return;
+
+                generation = m_generation;
+            }
+
+            runChunks(index);
+        }
+    }
+
+    void runChunks(size_t index)
+    {
+        Chunk chunk;
+        while (popChunk(index, chunk) || stealChunk(index, chunk))
+        {
+            try
+            {
+                m_job.invoke(m_job.fn, chunk.begin, chunk.end);
+            }
+            catch (...)
+            {
+                std::lock_guard lock(m_doneMutex);
+                if (!m_exception)
+                    m_exception = std::current_exception();
+            }
+
+            if (m_remaining.fetch_sub(1) == 1)
+            {
+                std::lock_guard lock(m_doneMutex);
+                m_done.notify_one();
+            }
+        }
+    }
+
+    bool popChunk(size_t index, Chunk &chunk)
+    {
+        auto &queue = *m_queues[index];
+        std::lock_guard lock(queue.mutex);
+        if (queue.chunks.empty())
+            return false;
+
+        chunk = queue.chunks.front();
+        queue.chunks.pop_front();
+        return true;
+    }
+
+    bool stealChunk(size_t index, Chunk &chunk)
+    {
+        for (size_t offset = 1; offset < size(); ++offset)
+        {
+            auto &queue = *m_queues[(index + offset) % size()];
+            std::lock_guard lock(queue.mutex);
+            if (queue.chunks.empty())
+                continue;
+
+            chunk = queue.chunks.back();
+            queue.chunks.pop_back();
+            return true;
+        }
+
+        return false;
+    }
+
+    // One queue per thread, with the calling thread's first
+    std::vector<std::unique_ptr<Queue>> m_queues{};
+    std::vector<std::thread> m_workers{};
+
+    std::mutex m_callMutex{};
+    Job m_job{};
+    std::atomic<size_t> m_remaining{};
+    std::exception_ptr m_exception{};
+
+    std::mutex m_wakeMutex{};
+    std::condition_variable m_wake{};
+    size_t m_generation{};
+    bool m_stop{false};
+
+    std::mutex m_doneMutex{};
+    std::condition_variable m_done{};
+};
+}; // namespace internal
+}; // namespace ECS
@@ -18,6 +18,41 @@ template <typename T> [[nodiscard]] std::string getTypeName()
     return typeid(T).name();
 }
 
+/**
+ * @brief Families of type ids, each of which is counted separately
+ *
+ * Component ids size every signature and flat table of sets, so groupings and other keys are given their own
+ * family and never leave gaps between component ids.
+ */
+namespace TypeIdFamily
+{
+struct Component
+{
+};
+
+struct Grouping
+{
+};
+} // namespace TypeIdFamily
+
+template <typename Family> size_t nextTypeId()
+{
+    static std::atomic<size_t> counter{0};
+    return counter++;
+}
+
+/**
+ * @brief Get a dense id for the type within the family, assigned the first time the type is used
+ *
+ * Ids start from 0 in every family and are shared by every manager, so they can be used to index flat tables
+ * directly.
+ */
+template <typename T, typename Family = TypeIdFamily::Component> [[nodiscard]] size_t getTypeId()
+{
+    static const size_t id = nextTypeId<Family>();
+    return id;
+}
+
 template <typename T, typename Base> [[nodiscard]] constexpr bool isBase()
 {
     if (std::is_base_of_v<Base, T>)
@@ -26,6 +61,19 @@ template <typename T, typename Base> [[nodiscard]] constexpr bool isBase()
     return false;
 }
 
+/**
+ * @brief Check that no type appears more than once in the list
+ */
+template <typename... Ts> [[nodiscard]] constexpr bool areDistinct()
+{
+    if constexpr (sizeof...(Ts) < 2)
+        return true;
+    else
+        return []<typename U, typename... Us>(std::type_identity<U>, std::type_identity<Us>...) {
+            return (!std::is_same_v<U, Us> && ...) && areDistinct<Us...>();
+        }(std::type_identity<Ts>{}...);
+}
+
 /**
  * @deprecated This will be removed in a future version - Recommend to use the magic_enum library instead
  *
@@ -135,6 +183,39 @@ template <typename Enum> [[nodiscard]] inline constexpr std::array<Enum, getEnum
 template <typename Func, typename... Args>
 concept ReturnsBool = std::is_invocable_r_v<bool, Func, Args...>;
 
+/**
+ * @brief Walk [0, size) in runs of indexes which are not skipped, with no run longer than the chunk size
+ *
+ * The function is called with the [begin, end) of each run, and can optionally return a bool to determine the
+ * loop-breaking behavior.  A false return value is a break.
+ */
+template <typename IsSkipped, typename Func>
+void forEachRun(size_t size, size_t chunkSize, IsSkipped &&isSkipped, Func &&fn)
+{
+    chunkSize = std::max<size_t>(chunkSize, 1);
+
+    for (size_t i = 0; i < size;)
+    {
+        if (isSkipped(i))
+        {
+            ++i;
+            continue;
+        }
+
+        auto begin = i;
+        while (i < size && i - begin < chunkSize && !isSkipped(i))
+            ++i;
+
+        if constexpr (ReturnsBool<Func, size_t, size_t>)
+        {
+            if (!fn(begin, i))
+                return;
+        }
+        else
+            fn(begin, i);
+    }
+}
+
 template <typename... Args> constexpr void print(const Args &...args)
 {
     std::cout << "\n  ";
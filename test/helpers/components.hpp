@@ -78,3 +78,30 @@ struct TestPositionComponent
     float x{0.0f};
     float y{0.0f};
 };
+
+struct TestDamageComponent : Stack
+{
+    int amount{};
+
+    TestDamageComponent()
+    {
+    }
+    TestDamageComponent(int _amount) : amount(_amount)
+    {
+    }
+};
+
+struct TestRotationComponent
+{
+    float angle{0.0f};
+};
+
+struct TestMassComponent
+{
+    float value{1.0f};
+};
+
+struct TestHealthComponent
+{
+    int value{100};
+};
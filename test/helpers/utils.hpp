@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../core.hpp"
+#include <unistd.h>
 
 inline std::function<void(Effect &)> markForCleanup = [](Effect &effect) { effect.cleanup = true; };
 
@@ -31,3 +32,17 @@ template <typename... Components> inline void createEntityWithComponents(CM &cm,
     for (int i = 1; i < entityCount + 1; ++i)
         (cm.add<Components>(i), ...);
 }
+
+/**
+ * @brief Resident set size of the current process in bytes.  Linux only, returns 0 elsewhere
+ */
+inline size_t getResidentMemory()
+{
+    std::ifstream statm("/proc/self/statm");
+    size_t pages{};
+    size_t residentPages{};
+    if (!(statm >> pages >> residentPages))
+        return 0;
+
+    return residentPages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
@@ -57,6 +57,32 @@ inline std::vector<testFn> componentManagerTests{
     test_sparse_set_auto_prune,
     test_sparse_set_auto_prune_after_removal,
 #endif
+
+    test_sparse_set_paged_index,
+    test_entity_id_recycling,
+    test_entity_id_destroy_unissued,
+    test_get_missing_component_does_not_insert,
+    test_contains_multiple_components,
+    test_non_stacked_component_views,
+    test_stacked_components_pool,
+    test_command_buffer,
+    test_group_intersection_order,
+    test_owning_group,
+    test_grouping_ids_leave_component_ids_dense,
+    test_cached_query,
+    test_parallel_each,
+    test_scheduler,
+    test_read_only_iteration,
+    test_chunked_iteration,
+    test_archetype_manager,
+    test_add_bulk,
+    test_entity_builder,
+    test_clone,
+    test_change_ticks,
+    test_component_events,
+    test_transformation_pipeline,
+    test_transformation_cache,
+    test_transform_all,
 };
 
 inline std::vector<testFn> utiltiesTests{
@@ -68,6 +94,7 @@ inline std::vector<testFn> utiltiesTests{
 
 inline std::vector<testFn> benchmarkTests{
     test_benchmark_2M_create,
+    test_benchmark_2M_create_bulk,
     test_benchmark_2M_get_single_entity_single_type,
     test_benchmark_2M_get_multiple_entities_single_type,
     test_benchmark_2M_get_all,
@@ -82,6 +109,25 @@ inline std::vector<testFn> benchmarkTests{
 #ifndef ecs_disable_auto_prune
     test_benchmark_2M_remove_and_auto_prune,
 #endif
+    test_benchmark_sparse_membership_memory,
+    test_benchmark_1M_probe_missing_then_iterate,
+    test_benchmark_200K_remove_entities_64_types,
+    test_benchmark_200K_stacked_add_and_iterate,
+    test_benchmark_1M_deferred_changes,
+    test_benchmark_2M_skewed_group,
+    test_benchmark_2M_skewed_entity_ids,
+    test_benchmark_2M_owning_group,
+    test_benchmark_2M_skewed_cached_query,
+    test_benchmark_2M_parallel_each_scaling,
+    test_benchmark_2M_read_only_each,
+    test_benchmark_2M_chunked_update,
+    test_benchmark_archetype_vs_sparse_set,
+    test_benchmark_200K_spawn_entities_5_components,
+    test_benchmark_200K_clone_prefab,
+    test_benchmark_2M_sync_changed_since,
+    test_benchmark_2M_react_to_spawns,
+    test_benchmark_500K_repeated_transformed_reads,
+    test_benchmark_500K_transform_all,
 };
 
 inline bool runTests(Tests testType) {
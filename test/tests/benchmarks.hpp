@@ -7,6 +7,7 @@ inline constexpr int COUNT_2K = 2000;
 inline constexpr int COUNT_65K = 65000;
 inline constexpr int COUNT_100K = 100000;
 inline constexpr int COUNT_200K = 200000;
+inline constexpr int COUNT_500K = 500000;
 inline constexpr int COUNT_1M = 1000000;
 inline constexpr int COUNT_2M = 2000000;
 
@@ -297,3 +298,713 @@ inline void test_benchmark_2M_remove_and_auto_prune(CM &cm)
 
     PRINT("TIME:", elapsed, "seconds");
 }
+
+template <int N> struct TestSparseMembershipComponent
+{
+    int value{N};
+};
+
+template <int... Ns>
+inline void addSparseMembership(CM &cm, std::integer_sequence<int, Ns...>, int stride, int first = 1)
+{
+    for (int i = first; i <= COUNT_2M; i += stride)
+        (cm.add<TestSparseMembershipComponent<Ns>>(i), ...);
+}
+
+template <int... Ns> inline size_t getSparseMembershipMemory(CM &cm, std::integer_sequence<int, Ns...>)
+{
+    return (std::get<0>(cm.getAll<TestSparseMembershipComponent<Ns>>()).sparseMemoryUsage() + ...);
+}
+
+inline void test_benchmark_sparse_membership_memory(CM &cm)
+{
+    PRINT("BENCHMARKING SPARSE MEMBERSHIP MEMORY 64 TYPES W/ 500 ENTITIES SPREAD OVER 2M IDS...")
+
+    constexpr int typeCount = 64;
+    constexpr int stride = COUNT_2M / 500;
+    auto types = std::make_integer_sequence<int, typeCount>{};
+
+    auto residentBefore = getResidentMemory();
+    Timer timer{1};
+
+    addSparseMembership(cm, types, stride);
+
+    auto elapsed = timer.getElapsedTime();
+    auto residentAfter = getResidentMemory();
+    auto sparseBytes = getSparseMembershipMemory(cm, types);
+    auto flatBytes = sizeof(size_t) * static_cast<size_t>(COUNT_2M) * typeCount;
+
+    PRINT("TIME:", elapsed, "seconds");
+    PRINT("SPARSE INDEX:", sparseBytes / 1024, "KiB - FLAT INDEX WOULD BE:", flatBytes / 1024, "KiB");
+    PRINT("RESIDENT MEMORY DELTA:", (residentAfter - residentBefore) / 1024, "KiB");
+}
+
+inline void test_benchmark_1M_probe_missing_then_iterate(CM &cm)
+{
+    PRINT("BENCHMARKING PROBING 1M MISSING COMPONENTS THEN ITERATE AND PRUNE 1M ENTITIES...")
+
+    uint32_t count{};
+
+    setupBenchmark(cm, COUNT_1M);
+    Timer probeTimer{1};
+
+    for (int i = COUNT_1M + 1; i <= COUNT_2M; ++i)
+    {
+        auto [posComps] = cm.get<TestPositionComponent>(i);
+        posComps.inspect([&](auto &_) { count++; });
+    }
+
+    auto probeElapsed = probeTimer.getElapsedTime();
+    Timer timer{1};
+
+    auto [posComps] = cm.getAll<TestPositionComponent>();
+    posComps.each([&](EId eId, auto &comps) { comps.inspect([&](auto &_) { count++; }); });
+    cm.prune<TestPositionComponent>();
+
+    auto elapsed = timer.getElapsedTime();
+
+    assert(count == COUNT_1M);
+
+    PRINT("PROBE TIME:", probeElapsed, "seconds");
+    PRINT("ITERATE AND PRUNE TIME:", elapsed, "seconds");
+}
+
+inline void test_benchmark_200K_remove_entities_64_types(CM &cm)
+{
+    PRINT("BENCHMARKING REMOVING 200K ENTITIES W/ 2 COMPONENTS WITH 64 OTHER COMPONENT TYPES...")
+
+    addSparseMembership(cm, std::make_integer_sequence<int, 64>{}, COUNT_2M, COUNT_2M);
+    setupBenchmark(cm, COUNT_200K);
+    Timer timer{1};
+
+    for (int i = 1; i <= COUNT_200K; ++i)
+        cm.remove(static_cast<EntityId>(i));
+
+    auto elapsed = timer.getElapsedTime();
+
+    assert(!cm.contains<TestVelocityComponent>(COUNT_200K));
+    assert(cm.contains<TestSparseMembershipComponent<0>>(COUNT_2M));
+
+    PRINT("TIME:", elapsed, "seconds");
+}
+
+inline void test_benchmark_200K_stacked_add_and_iterate(CM &cm)
+{
+    PRINT("BENCHMARKING ADDING 4 STACKED COMPONENTS TO 200K ENTITIES THEN ITERATE...")
+
+    constexpr int rounds = 4;
+    int64_t total{};
+
+    Timer addTimer{1};
+
+    // Round-robin adds, so every entity's stack grows after others have been added to
+    for (int round = 1; round <= rounds; ++round)
+    {
+        for (int i = 1; i <= COUNT_200K; ++i)
+            cm.add<TestDamageComponent>(i, round);
+    }
+
+    auto addElapsed = addTimer.getElapsedTime();
+    Timer timer{1};
+
+    auto [damageComps] = cm.getAll<TestDamageComponent>();
+    damageComps.each([&](EId eId, auto &comps) {
+        comps.inspect([&](const TestDamageComponent &damage) { total += damage.amount; });
+    });
+
+    auto elapsed = timer.getElapsedTime();
+
+    assert(total == int64_t{COUNT_200K} * (rounds * (rounds + 1) / 2));
+
+    PRINT("ADD TIME:", addElapsed, "seconds");
+    PRINT("ITERATE TIME:", elapsed, "seconds");
+}
+
+inline void test_benchmark_1M_deferred_changes(CM &cm)
+{
+    PRINT("BENCHMARKING DEFERRING CHANGES TO 1M ENTITIES W/ 2 COMPONENTS DURING ITERATION...")
+
+    setupBenchmark(cm, COUNT_1M);
+    ECS::CommandBuffer<EntityId> commands(cm);
+    Timer timer{1};
+
+    auto [posComps] = cm.getAll<TestPositionComponent>();
+    posComps.each([&](EId eId, auto &comps) {
+        if (eId % 2 == 0)
+            commands.remove<TestVelocityComponent>(eId);
+        else
+            commands.add<TestDamageComponent>(eId, 1);
+    });
+
+    commands.apply();
+
+    auto elapsed = timer.getElapsedTime();
+
+    assert(!cm.contains<TestVelocityComponent>(2));
+    assert(cm.contains<TestDamageComponent>(1));
+
+    PRINT("TIME:", elapsed, "seconds");
+}
+
+inline constexpr int COUNT_5K = 5000;
+
+/**
+ * @brief Velocity for 2M entities, and position for 5K of them spread evenly across the ids
+ */
+inline void setupSkewedBenchmark(CM &cm)
+{
+    constexpr int stride = COUNT_2M / COUNT_5K;
+
+    for (int i = 1; i <= COUNT_2M; ++i)
+    {
+        cm.add<TestVelocityComponent>(i);
+        if (i % stride == 0)
+            cm.add<TestPositionComponent>(i);
+    }
+}
+
+inline void test_benchmark_2M_skewed_group(CM &cm)
+{
+    PRINT("BENCHMARKING GATHER GROUP 2M INTERSECT 5K ENTITIES...")
+
+    uint32_t count{};
+
+    setupSkewedBenchmark(cm);
+    Timer timer{1};
+
+    for (int i = 0; i < 100; ++i)
+    {
+        auto group = cm.getGroup<TestVelocityComponent, TestPositionComponent>();
+        group.each([&](EId eId, auto &velComps, auto &posComps) { count++; });
+    }
+
+    auto elapsed = timer.getElapsedTime();
+
+    assert(count == COUNT_5K * 100);
+
+    PRINT("TIME:", elapsed, "seconds");
+}
+
+inline void test_benchmark_2M_skewed_entity_ids(CM &cm)
+{
+    PRINT("BENCHMARKING GET ENTITY IDS 5K INTERSECT 2M ENTITIES...")
+
+    size_t count{};
+
+    setupSkewedBenchmark(cm);
+    Timer timer{1};
+
+    for (int i = 0; i < 100; ++i)
+        count += cm.getEntityIds<TestPositionComponent, TestVelocityComponent>().size();
+
+    auto elapsed = timer.getElapsedTime();
+
+    assert(count == COUNT_5K * 100);
+
+    PRINT("TIME:", elapsed, "seconds");
+}
+
+inline void test_benchmark_2M_owning_group(CM &cm)
+{
+    PRINT("BENCHMARKING ITERATE OWNING GROUP 2M ENTITIES W/ 2 COMPONENTS...")
+
+    uint32_t count1{};
+    uint32_t count2{};
+
+    setupBenchmark(cm, COUNT_2M);
+    auto &group = cm.getOwningGroup<TestVelocityComponent, TestPositionComponent>();
+    Timer timer{1};
+
+    group.each([&](EId eId, auto &velComps, auto &posComps) {
+        velComps.inspect([&](auto &_) { count1++; });
+        posComps.inspect([&](auto &_) { count2++; });
+    });
+
+    auto elapsed = timer.getElapsedTime();
+
+    assert(count1 == COUNT_2M);
+    assert(count2 == COUNT_2M);
+
+    PRINT("TIME:", elapsed, "seconds");
+}
+
+inline void test_benchmark_2M_skewed_cached_query(CM &cm)
+{
+    PRINT("BENCHMARKING CACHED QUERY 2M INTERSECT 5K ENTITIES W/ CHANGES BETWEEN FRAMES...")
+
+    constexpr int stride = COUNT_2M / COUNT_5K;
+    uint32_t count{};
+
+    setupSkewedBenchmark(cm);
+    auto &query = cm.getQuery<TestVelocityComponent, TestPositionComponent>();
+    Timer timer{1};
+
+    for (int i = 1; i <= 100; ++i)
+    {
+        cm.remove<TestPositionComponent>(EntityId(i * stride));
+        cm.add<TestPositionComponent>(EntityId(i * stride + 1));
+
+        query.each([&](EId eId, auto &velComps, auto &posComps) { count++; });
+    }
+
+    auto elapsed = timer.getElapsedTime();
+
+    assert(count == COUNT_5K * 100);
+
+    PRINT("TIME:", elapsed, "seconds");
+}
+
+inline void test_benchmark_2M_parallel_each_scaling(CM &cm)
+{
+    PRINT("BENCHMARKING PARALLEL EACH 2M ENTITIES W/ 2 COMPONENTS FROM 1 TO N THREADS...")
+
+    setupBenchmark(cm, COUNT_2M);
+    auto group = cm.getGroup<TestVelocityComponent, TestPositionComponent>();
+
+    // Powers of two up to the hardware concurrency, and the hardware concurrency itself
+    auto maxThreads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    std::vector<size_t> threadCounts;
+    for (size_t threads = 1; threads < maxThreads; threads *= 2)
+        threadCounts.push_back(threads);
+    threadCounts.push_back(maxThreads);
+
+    float singleThreaded{};
+    for (auto threads : threadCounts)
+    {
+        ECS::ThreadPool pool{threads};
+        Timer timer{1};
+
+        group.parallelEach(pool, [](EId eId, auto &velComps, auto &posComps) {
+            velComps.inspect([&](const TestVelocityComponent &vel) {
+                posComps.mutate([&](TestPositionComponent &pos) {
+                    pos.x += vel.x;
+                    pos.y += vel.y;
+                });
+            });
+        });
+
+        auto elapsed = timer.getElapsedTime();
+        if (threads == 1)
+            singleThreaded = elapsed;
+
+        PRINT("THREADS:", threads, "TIME:", elapsed, "seconds", "SPEEDUP:", singleThreaded / elapsed);
+    }
+
+    size_t count{};
+    group.each([&](EId eId, auto &velComps, auto &posComps) {
+        posComps.inspect([&](const TestPositionComponent &pos) { count += pos.x == threadCounts.size(); });
+    });
+    assert(count == COUNT_2M);
+}
+
+inline void test_benchmark_2M_read_only_each(CM &cm)
+{
+    PRINT("BENCHMARKING READ-ONLY EACH 2M ENTITIES W/ 2 COMPONENTS...")
+
+    uint32_t count1{};
+    uint32_t count2{};
+
+    setupBenchmark(cm, COUNT_2M);
+    Timer timer{1};
+
+    auto [velSet, posSet] = cm.getAll<TestVelocityComponent, TestPositionComponent>();
+    const auto &velComps = velSet;
+    const auto &posComps = posSet;
+    velComps.each([&](EId eId, const auto &comps) { comps.inspect([&](auto &_) { count1++; }); });
+    posComps.each([&](EId eId, const auto &comps) { comps.inspect([&](auto &_) { count2++; }); });
+
+    auto elapsed = timer.getElapsedTime();
+
+    assert(count1 == COUNT_2M);
+    assert(count2 == COUNT_2M);
+
+    PRINT("TIME:", elapsed, "seconds");
+}
+
+inline void test_benchmark_2M_chunked_update(CM &cm)
+{
+    PRINT("BENCHMARKING CHUNKED UPDATE 2M ENTITIES W/ 2 COMPONENTS, POSITION += VELOCITY * DT...")
+
+    constexpr float dt = 0.5f;
+
+    setupBenchmark(cm, COUNT_2M);
+    auto &group = cm.getOwningGroup<TestPositionComponent, TestVelocityComponent>();
+
+    Timer eachTimer{1};
+    group.each([&](EId eId, auto &posComps, auto &velComps) {
+        velComps.inspect([&](const TestVelocityComponent &vel) {
+            posComps.mutate([&](TestPositionComponent &pos) {
+                pos.x += vel.x * dt;
+                pos.y += vel.y * dt;
+            });
+        });
+    });
+    auto eachElapsed = eachTimer.getElapsedTime();
+
+    Timer timer{1};
+    group.eachChunk([&](std::span<const EId> ids, std::span<TestPositionComponent> positions,
+                        std::span<TestVelocityComponent> velocities) {
+        for (size_t i = 0; i < ids.size(); ++i)
+        {
+            positions[i].x += velocities[i].x * dt;
+            positions[i].y += velocities[i].y * dt;
+        }
+    });
+    auto elapsed = timer.getElapsedTime();
+
+    auto [posComps] = cm.get<TestPositionComponent>(COUNT_2M);
+    assert(posComps.peek(&TestPositionComponent::x) == 1.0f);
+
+    PRINT("EACH TIME:", eachElapsed, "seconds");
+    PRINT("TIME:", elapsed, "seconds");
+}
+
+
+template <typename Manager> inline float benchmarkStructuralChurn(Manager &manager, int entityCount, int rounds)
+{
+    for (EId id = 1; id <= static_cast<EId>(entityCount); ++id)
+        manager.template add<TestVelocityComponent>(id);
+
+    Timer timer{1};
+    for (int round = 0; round < rounds; ++round)
+    {
+        for (EId id = 1; id <= static_cast<EId>(entityCount); ++id)
+            manager.template add<TestPositionComponent>(id);
+
+        for (EId id = 1; id <= static_cast<EId>(entityCount); ++id)
+            manager.template remove<TestPositionComponent>(id);
+    }
+
+    return timer.getElapsedTime();
+}
+
+template <typename Manager> inline float benchmarkFiveTypeIteration(Manager &manager, int entityCount)
+{
+    for (EId id = 1; id <= static_cast<EId>(entityCount); ++id)
+    {
+        manager.template add<TestPositionComponent>(id);
+        manager.template add<TestVelocityComponent>(id);
+        manager.template add<TestRotationComponent>(id);
+        manager.template add<TestMassComponent>(id);
+        manager.template add<TestHealthComponent>(id);
+    }
+
+    constexpr float dt = 0.5f;
+
+    Timer timer{1};
+    auto group = manager.template getGroup<TestPositionComponent, TestVelocityComponent, TestRotationComponent,
+                                           TestMassComponent, TestHealthComponent>();
+    group.each(
+        [&](EId eId, auto &posComps, auto &velComps, auto &rotComps, auto &massComps, auto &healthComps) {
+            auto mass = massComps.peek(&TestMassComponent::value);
+            velComps.inspect([&](const TestVelocityComponent &vel) {
+                posComps.mutate([&](TestPositionComponent &pos) {
+                    pos.x += vel.x * dt / mass;
+                    pos.y += vel.y * dt / mass;
+                });
+            });
+            rotComps.mutate([&](TestRotationComponent &rot) { rot.angle += dt; });
+            healthComps.mutate([&](TestHealthComponent &health) { --health.value; });
+        });
+
+    return timer.getElapsedTime();
+}
+
+inline void test_benchmark_archetype_vs_sparse_set(CM &cm)
+{
+    PRINT("BENCHMARKING ARCHETYPE TABLES VS SPARSE SETS, 200K ADD/REMOVE CHURN, 1M ENTITIES W/ 5 COMPONENTS...")
+
+    constexpr int rounds = 5;
+
+    ECS::ArchetypeManager<EId> churnTables;
+    CM churnSets;
+    auto tablesChurn = benchmarkStructuralChurn(churnTables, COUNT_200K, rounds);
+    auto setsChurn = benchmarkStructuralChurn(churnSets, COUNT_200K, rounds);
+
+    ECS::ArchetypeManager<EId> iterationTables;
+    CM iterationSets;
+    auto tablesIteration = benchmarkFiveTypeIteration(iterationTables, COUNT_1M);
+    auto setsIteration = benchmarkFiveTypeIteration(iterationSets, COUNT_1M);
+
+    PRINT("SPARSE SET CHURN TIME:", setsChurn, "seconds");
+    PRINT("ARCHETYPE CHURN TIME:", tablesChurn, "seconds");
+    PRINT("SPARSE SET ITERATION TIME:", setsIteration, "seconds");
+    PRINT("ARCHETYPE ITERATION TIME:", tablesIteration, "seconds");
+    PRINT("TIME:", tablesChurn + tablesIteration, "seconds");
+}
+
+inline void test_benchmark_2M_create_bulk(CM &cm)
+{
+    PRINT("BENCHMARKING BULK CREATING 2M ENTITIES W/ 2 COMPONENTS...")
+
+    std::vector<EId> ids(COUNT_2M);
+    std::iota(ids.begin(), ids.end(), EId{1});
+
+    Timer timer{1};
+    cm.addBulk<TestVelocityComponent>(ids);
+    cm.addBulk<TestPositionComponent>(ids);
+    auto elapsed = timer.getElapsedTime();
+
+    assert((cm.getGroup<TestVelocityComponent, TestPositionComponent>().size() == COUNT_2M));
+
+    PRINT("TIME:", elapsed, "seconds");
+}
+
+inline void test_benchmark_200K_spawn_entities_5_components(CM &cm)
+{
+    PRINT("BENCHMARKING SPAWNING 200K ENTITIES W/ 5 COMPONENTS, ADD VS BUILDER VS BATCH...")
+
+    Timer addTimer{1};
+    for (int i = 0; i < COUNT_200K; ++i)
+    {
+        auto eId = cm.createEntity();
+        cm.add<TestPositionComponent>(eId);
+        cm.add<TestVelocityComponent>(eId);
+        cm.add<TestRotationComponent>(eId);
+        cm.add<TestMassComponent>(eId);
+        cm.add<TestHealthComponent>(eId);
+    }
+    auto addElapsed = addTimer.getElapsedTime();
+
+    CM builderCm;
+    Timer builderTimer{1};
+    for (int i = 0; i < COUNT_200K; ++i)
+        (void)builderCm.createEntity<TestPositionComponent, TestVelocityComponent, TestRotationComponent,
+                                     TestMassComponent, TestHealthComponent>();
+    auto builderElapsed = builderTimer.getElapsedTime();
+
+    CM batchCm;
+    Timer timer{1};
+    auto ids = batchCm.createEntities<TestPositionComponent, TestVelocityComponent, TestRotationComponent,
+                                      TestMassComponent, TestHealthComponent>(COUNT_200K);
+    auto elapsed = timer.getElapsedTime();
+
+    assert(ids.size() == COUNT_200K);
+
+    PRINT("ADD TIME:", addElapsed, "seconds");
+    PRINT("BUILDER TIME:", builderElapsed, "seconds");
+    PRINT("TIME:", elapsed, "seconds");
+}
+
+inline void test_benchmark_200K_clone_prefab(CM &cm)
+{
+    PRINT("BENCHMARKING CLONING A PREFAB W/ 5 COMPONENTS INTO 200K ENTITIES, GET/ADD VS CLONE...")
+
+    constexpr EId prefab = 1;
+    cm.add<TestPositionComponent>(prefab);
+    cm.add<TestVelocityComponent>(prefab);
+    cm.add<TestRotationComponent>(prefab);
+    cm.add<TestMassComponent>(prefab);
+    cm.add<TestDamageComponent>(prefab, 1);
+
+    CM addCm;
+    addCm.add<TestPositionComponent>(prefab);
+    addCm.add<TestVelocityComponent>(prefab);
+    addCm.add<TestRotationComponent>(prefab);
+    addCm.add<TestMassComponent>(prefab);
+    addCm.add<TestDamageComponent>(prefab, 1);
+
+    Timer addTimer{1};
+    for (int i = 0; i < COUNT_200K; ++i)
+    {
+        auto eId = addCm.createEntity();
+        auto [pos, vel, rot, mass, damage] =
+            addCm.get<TestPositionComponent, TestVelocityComponent, TestRotationComponent, TestMassComponent,
+                      TestDamageComponent>(prefab);
+        pos.inspect([&](const TestPositionComponent &comp) { addCm.add<TestPositionComponent>(eId, comp); });
+        vel.inspect([&](const TestVelocityComponent &comp) { addCm.add<TestVelocityComponent>(eId, comp); });
+        rot.inspect([&](const TestRotationComponent &comp) { addCm.add<TestRotationComponent>(eId, comp); });
+        mass.inspect([&](const TestMassComponent &comp) { addCm.add<TestMassComponent>(eId, comp); });
+        damage.inspect([&](const TestDamageComponent &comp) { addCm.add<TestDamageComponent>(eId, comp); });
+    }
+    auto addElapsed = addTimer.getElapsedTime();
+
+    Timer timer{1};
+    auto ids = cm.clone(prefab, COUNT_200K);
+    auto elapsed = timer.getElapsedTime();
+
+    assert(ids.size() == COUNT_200K);
+    assert((cm.getGroup<TestPositionComponent, TestDamageComponent>().size() == COUNT_200K + 1));
+
+    PRINT("GET/ADD TIME:", addElapsed, "seconds");
+    PRINT("TIME:", elapsed, "seconds");
+}
+
+inline void test_benchmark_2M_sync_changed_since(CM &cm)
+{
+    PRINT("BENCHMARKING SYNCING 2M ENTITIES W/ 1% CHANGED, FULL EACH VS CHANGED SINCE...")
+
+    setupBenchmark(cm, COUNT_2M);
+    auto lastSync = cm.advanceTick();
+
+    for (EId id = 1; id <= COUNT_2M; id += 100)
+    {
+        auto [posComps] = cm.get<TestPositionComponent>(id);
+        posComps.mutate([](TestPositionComponent &pos) { pos.x += 1.0f; });
+    }
+
+    auto [posSet] = cm.getAll<TestPositionComponent>();
+    const auto &constPosSet = posSet;
+
+    float fullSum{};
+    Timer fullTimer{1};
+    constPosSet.each([&](EId eId, const auto &posComps) { fullSum += posComps.peek(&TestPositionComponent::x); });
+    auto fullElapsed = fullTimer.getElapsedTime();
+
+    float changedSum{};
+    size_t changed{};
+    Timer timer{1};
+    constPosSet.eachChangedSince(lastSync, [&](EId eId, const auto &posComps) {
+        changedSum += posComps.peek(&TestPositionComponent::x);
+        ++changed;
+    });
+    auto elapsed = timer.getElapsedTime();
+
+    assert(changed == COUNT_2M / 100);
+    assert(fullSum == changedSum);
+
+    PRINT("FULL EACH TIME:", fullElapsed, "seconds");
+    PRINT("TIME:", elapsed, "seconds");
+}
+
+inline void test_benchmark_2M_react_to_spawns(CM &cm)
+{
+    PRINT("BENCHMARKING REACTING TO 1K SPAWNS PER FRAME AMONG 2M ENTITIES, ID DIFF VS DRAINED EVENTS...")
+
+    constexpr int frames = 5;
+    constexpr int spawnsPerFrame = 1000;
+
+    setupBenchmark(cm, COUNT_2M);
+    cm.observe<TestVelocityComponent>();
+    cm.drainEvents<TestVelocityComponent>([](const auto &events) {});
+
+    auto spawn = [&](EId first) {
+        for (EId id = first; id < first + spawnsPerFrame; ++id)
+            cm.add<TestVelocityComponent>(id);
+    };
+
+    auto previous = cm.getEntityIds<TestVelocityComponent>();
+    std::sort(previous.begin(), previous.end());
+
+    size_t diffSpawned{};
+    Timer diffTimer{1};
+    for (int frame = 0; frame < frames; ++frame)
+    {
+        spawn(COUNT_2M + 1 + frame * spawnsPerFrame);
+
+        auto current = cm.getEntityIds<TestVelocityComponent>();
+        std::sort(current.begin(), current.end());
+
+        std::vector<EId> spawned;
+        std::set_difference(current.begin(), current.end(), previous.begin(), previous.end(),
+                            std::back_inserter(spawned));
+        diffSpawned += spawned.size();
+        previous = std::move(current);
+    }
+    auto diffElapsed = diffTimer.getElapsedTime();
+
+    // The diffed spawns were queued as well
+    cm.drainEvents<TestVelocityComponent>([](const auto &events) {});
+
+    size_t drainedSpawned{};
+    Timer timer{1};
+    for (int frame = 0; frame < frames; ++frame)
+    {
+        spawn(COUNT_2M + 1 + (frames + frame) * spawnsPerFrame);
+        cm.drainEvents<TestVelocityComponent>([&](const auto &events) { drainedSpawned += events.added.size(); });
+    }
+    auto elapsed = timer.getElapsedTime();
+
+    assert(diffSpawned == frames * spawnsPerFrame);
+    assert(drainedSpawned == frames * spawnsPerFrame);
+
+    PRINT("ID DIFF TIME:", diffElapsed, "seconds");
+    PRINT("TIME:", elapsed, "seconds");
+}
+
+inline void test_benchmark_500K_repeated_transformed_reads(CM &cm)
+{
+    PRINT("BENCHMARKING 4 TRANSFORMED READS OF 500K ENTITIES IN A FRAME, FIRST READ VS CACHED READS...")
+
+    constexpr int reads = 3;
+
+    cm.registerTransformation<TestHealthComponent>([](EId eId, TestHealthComponent health) {
+        health.value = health.value * 3 / 2 + 5;
+        return health;
+    });
+
+    for (EId id = 1; id <= COUNT_500K; ++id)
+        cm.add<TestHealthComponent>(id);
+
+    auto [healthComps] = cm.getAll<TestHealthComponent>();
+    auto readAll = [&]() {
+        int64_t total{};
+        healthComps.each([&](EId eId, auto &comps) {
+            total += comps.peek(ECS::internal::Transformation::TRANSFORM, &TestHealthComponent::value);
+        });
+        return total;
+    };
+
+    Timer firstTimer{1};
+    auto expected = readAll();
+    auto firstElapsed = firstTimer.getElapsedTime();
+
+    Timer timer{1};
+    for (int read = 0; read < reads; ++read)
+        assert(readAll() == expected);
+    auto elapsed = timer.getElapsedTime() / reads;
+
+    assert(expected == int64_t{COUNT_500K} * 155);
+
+    PRINT("FIRST READ TIME:", firstElapsed, "seconds");
+    PRINT("CACHED READ TIME:", elapsed, "seconds");
+}
+
+inline void test_benchmark_500K_transform_all(CM &cm)
+{
+    PRINT("BENCHMARKING TRANSFORMING 500K STAT MODIFIERS, PER ENTITY READS VS TRANSFORM ALL...")
+
+    cm.registerTransformation<TestHealthComponent>([](EId eId, TestHealthComponent health) {
+        health.value = health.value * 3 / 2 + 5;
+        return health;
+    });
+
+    for (EId id = 1; id <= COUNT_500K; ++id)
+        cm.add<TestHealthComponent>(id);
+
+    auto [healthComps] = cm.getAll<TestHealthComponent>();
+    auto readAll = [&]() {
+        int64_t total{};
+        healthComps.each([&](EId eId, auto &comps) {
+            total += comps.peek(ECS::internal::Transformation::TRANSFORM, &TestHealthComponent::value);
+        });
+        return total;
+    };
+
+    Timer lazyTimer{1};
+    auto lazyTotal = readAll();
+    auto lazyElapsed = lazyTimer.getElapsedTime();
+
+    cm.invalidateTransformation<TestHealthComponent>();
+
+    Timer timer{1};
+    cm.transformAll<TestHealthComponent>();
+    auto transformElapsed = timer.getElapsedTime();
+    auto total = readAll();
+    auto elapsed = timer.getElapsedTime();
+
+    cm.invalidateTransformation<TestHealthComponent>();
+
+    Timer parallelTimer{1};
+    cm.parallelTransformAll<TestHealthComponent>();
+    auto parallelTransformElapsed = parallelTimer.getElapsedTime();
+
+    assert(lazyTotal == int64_t{COUNT_500K} * 155);
+    assert(total == lazyTotal);
+    assert(readAll() == lazyTotal);
+
+    PRINT("PER ENTITY TIME:", lazyElapsed, "seconds");
+    PRINT("TRANSFORM ALL TIME:", transformElapsed, "seconds");
+    PRINT("PARALLEL TRANSFORM ALL TIME:", parallelTransformElapsed, "seconds");
+    PRINT("TRANSFORM ALL AND READ TIME:", elapsed, "seconds");
+}
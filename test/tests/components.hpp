@@ -229,11 +229,12 @@ inline void test_add_stacked_components(CM &cm)
     PRINT("TESTING ADD STACKED COMPONENTS")
 
     EntityId id = 2;
-    auto [comp] = cm.get<TestStackedComp>(id);
-    assert(comp.size() == 0);
+    auto [emptyComp] = cm.get<TestStackedComp>(id);
+    assert(emptyComp.size() == 0);
 
     cm.add<TestStackedComp>(id);
 
+    auto [comp] = cm.get<TestStackedComp>(id);
     assert(comp.size() == 1);
 
     cm.add<TestStackedComp>(id);
@@ -610,3 +611,1460 @@ inline void test_prune_by_tag(CM &cm)
     assert(timedEffectSet.size() == 2);
 }
 #endif
+
+inline void test_sparse_set_paged_index(CM &cm)
+{
+    PRINT("TESTING SPARSE SET PAGED INDEX")
+
+    EntityId lowId{1};
+    EntityId highId{1000000};
+    cm.add<TestNonStackedComp>(lowId);
+
+    auto [compsSet] = cm.getAll<TestNonStackedComp>();
+    auto singlePageUsage = compsSet.sparseMemoryUsage();
+
+    cm.add<TestNonStackedComp>(highId);
+    auto twoPageUsage = compsSet.sparseMemoryUsage();
+
+    assert(twoPageUsage > singlePageUsage);
+    assert(twoPageUsage < sizeof(size_t) * highId);
+
+    cm.remove<TestNonStackedComp>(highId);
+
+    assert(cm.contains<TestNonStackedComp>(lowId));
+    assert(!cm.contains<TestNonStackedComp>(highId));
+    assert(compsSet.sparseMemoryUsage() < twoPageUsage);
+}
+
+inline void test_entity_id_recycling(CM &cm)
+{
+    PRINT("TESTING ENTITY ID RECYCLING")
+
+    using Entity = ECS::internal::EntityTraits<EntityId>;
+
+    EntityId staleId = cm.createEntity();
+    cm.add<TestNonStackedComp>(staleId, 1);
+
+    assert(cm.isAlive(staleId));
+
+    cm.destroyEntity(staleId);
+
+    assert(!cm.isAlive(staleId));
+    assert(!cm.contains<TestNonStackedComp>(staleId));
+
+    EntityId recycledId = cm.createEntity();
+
+    assert(recycledId != staleId);
+    assert(Entity::getIndex(recycledId) == Entity::getIndex(staleId));
+    assert(Entity::getVersion(recycledId) == Entity::getVersion(staleId) + 1);
+
+    cm.add<TestNonStackedComp>(recycledId, 2);
+    cm.add<TestNonStackedComp>(staleId, 3);
+
+    assert(cm.contains<TestNonStackedComp>(recycledId));
+    assert(!cm.contains<TestNonStackedComp>(staleId));
+
+    auto [staleComps] = cm.get<TestNonStackedComp>(staleId);
+    assert(staleComps.size() == 0);
+
+    auto [recycledComps] = cm.get<TestNonStackedComp>(recycledId);
+    assert(recycledComps.peek(&TestNonStackedComp::val) == 2);
+}
+
+inline void test_entity_id_destroy_unissued(CM &cm)
+{
+    PRINT("TESTING ENTITY ID DESTROY UNISSUED")
+
+    using Entity = ECS::internal::EntityTraits<EntityId>;
+
+    EntityId destroyedId = cm.createEntity();
+    cm.destroyEntity(destroyedId);
+
+    EntityId guessedId = Entity::nextVersion(destroyedId);
+
+    assert(!cm.isAlive(destroyedId));
+    assert(!cm.isAlive(guessedId));
+
+    cm.destroyEntity(guessedId);
+
+    EntityId firstId = cm.createEntity();
+    EntityId secondId = cm.createEntity();
+
+    assert(firstId == guessedId);
+    assert(secondId != firstId);
+    assert(cm.isAlive(firstId));
+    assert(cm.isAlive(secondId));
+}
+
+inline void test_get_missing_component_does_not_insert(CM &cm)
+{
+    PRINT("TESTING GET MISSING COMPONENT DOES NOT INSERT")
+
+    EntityId id1 = 1;
+    EntityId id2 = 2;
+    cm.add<TestNonStackedComp>(id1);
+
+    auto [missingComps] = cm.get<TestNonStackedComp>(id2);
+    auto [missingStackedComps] = cm.get<TestStackedComp>(id2);
+
+    assert(missingComps.size() == 0);
+    assert(missingStackedComps.size() == 0);
+
+    auto [compsSet] = cm.getAll<TestNonStackedComp>();
+    assert(compsSet.size() == 1);
+    assert(!cm.contains<TestNonStackedComp>(id2));
+    assert(!cm.exists<TestStackedComp>());
+}
+
+inline void test_contains_multiple_components(CM &cm)
+{
+    PRINT("TESTING CONTAINS MULTIPLE COMPONENTS")
+
+    EntityId id1 = 1;
+    EntityId id2 = 2;
+    cm.add<TestNonStackedComp>(id1);
+    cm.add<TestStackedComp>(id1);
+    cm.add<TestNonStackedComp>(id2);
+    cm.add<TestEventComp>(id2);
+
+    assert((cm.contains<TestNonStackedComp, TestStackedComp>(id1)));
+    assert(!(cm.contains<TestNonStackedComp, TestStackedComp>(id2)));
+    assert((cm.contains<TestNonStackedComp, TestEventComp>(id2)));
+
+    cm.remove(id1);
+
+    assert(!cm.contains<TestNonStackedComp>(id1));
+    assert(!cm.contains<TestStackedComp>(id1));
+    assert((cm.contains<TestNonStackedComp, TestEventComp>(id2)));
+
+    cm.add<TestStackedComp>(id2);
+    cm.clear<TestStackedComp>();
+
+    assert(!cm.contains<TestStackedComp>(id2));
+
+    auto [comps] = cm.get<TestEventComp>(id2);
+    comps.remove([&](const TestEventComp &_) { return true; });
+    cm.prune<TestEventComp>();
+
+    assert(!cm.contains<TestEventComp>(id2));
+    assert(cm.contains<TestNonStackedComp>(id2));
+}
+
+inline void test_non_stacked_component_views(CM &cm)
+{
+    PRINT("TESTING NON-STACKED COMPONENT VIEWS")
+
+    EntityId id1 = 1;
+    EntityId id2 = 2;
+    cm.add<TestNonStackedComp>(id1, 1);
+    cm.add<TestNonStackedComp>(id2, 2);
+
+    auto [comps1] = cm.get<TestNonStackedComp>(id1);
+    comps1.mutate([&](TestNonStackedComp &comp) { comp.val = 10; });
+
+    auto [sameComps1] = cm.get<TestNonStackedComp>(id1);
+    assert(sameComps1.peek(&TestNonStackedComp::val) == 10);
+
+    comps1.remove([&](const TestNonStackedComp &_) { return true; });
+
+    assert(sameComps1.size() == 0);
+    assert(!cm.contains<TestNonStackedComp>(id1));
+
+    cm.add<TestNonStackedComp>(id1, 3);
+
+    auto [compsSet] = cm.getAll<TestNonStackedComp>();
+    assert(compsSet.size() == 2);
+
+    cm.registerTransformation<TestNonStackedComp>([](EntityId eId, TestNonStackedComp comp) {
+        comp.val += eId;
+        return comp;
+    });
+
+    int sum{};
+    compsSet.each([&](EId eId, auto &comps) {
+        int transformed = comps.peek(ECS::internal::Transformation::TRANSFORM, &TestNonStackedComp::val);
+        int val = comps.peek(&TestNonStackedComp::val);
+
+        assert(transformed == val + eId);
+        sum += val;
+    });
+
+    assert(sum == 5);
+}
+
+inline void test_stacked_components_pool(CM &cm)
+{
+    PRINT("TESTING STACKED COMPONENTS POOL")
+
+    constexpr int entityCount = 200;
+    constexpr int rounds = 3;
+
+    // Adding in turn makes every stack outgrow its range after other stacks were added to
+    for (int round = 0; round < rounds; ++round)
+    {
+        for (EntityId id = 1; id <= entityCount; ++id)
+            cm.add<TestStackedComp>(id, id * 10 + round);
+    }
+
+    // Removing entities leaves unused space behind, which eventually compacts the pool
+    for (EntityId id = 1; id <= entityCount; id += 2)
+        cm.remove<TestStackedComp>(id);
+
+    for (EntityId id = 2; id <= entityCount; id += 4)
+    {
+        auto [comps] = cm.get<TestStackedComp>(id);
+        comps.remove([&](const TestStackedComp &comp) { return comp.val % 10 == 1; });
+    }
+
+    auto [compsSet] = cm.getAll<TestStackedComp>();
+    assert(compsSet.size() == entityCount / 2);
+
+    compsSet.each([&](EId eId, auto &comps) {
+        bool isFiltered = eId % 4 == 2;
+        assert(comps.size() == (isFiltered ? rounds - 1 : rounds));
+
+        std::vector<int> vals;
+        comps.inspect([&](const TestStackedComp &comp) { vals.push_back(comp.val); });
+
+        for (int i = 0, round = 0; round < rounds; ++round)
+        {
+            if (isFiltered && round == 1)
+                continue;
+
+            assert(vals[i++] == static_cast<int>(eId) * 10 + round);
+        }
+    });
+
+    cm.add<TestStackedComp>(2, 1);
+    cm.overwrite<TestStackedComp>(4, 7);
+
+    auto [comps2, comps4] = cm.get<TestStackedComp>(2, 4);
+    assert(comps2.size() == rounds);
+    assert(comps4.size() == 1);
+    assert(comps4.reduce([](TestStackedComp &sum, const TestStackedComp &comp) { sum.val += comp.val; }).val == 7);
+}
+
+inline void test_command_buffer(CM &cm)
+{
+    PRINT("TESTING COMMAND BUFFER")
+
+    for (EntityId id = 1; id <= 4; ++id)
+    {
+        cm.add<TestNonStackedComp>(id, id);
+        cm.add<TestStackedComp>(id, id);
+    }
+
+    ECS::CommandBuffer<EntityId> commands(cm);
+    EntityId createdId{};
+
+    auto [compsSet] = cm.getAll<TestNonStackedComp>();
+    compsSet.each([&](EId eId, auto &comps) {
+        if (eId % 2 == 0)
+        {
+            commands.remove<TestNonStackedComp>(eId);
+            commands.add<TestStackedComp>(eId, 5);
+        }
+        else
+            commands.overwrite<TestNonStackedComp>(eId, eId * 100);
+
+        if (eId == 3)
+            commands.remove(eId);
+
+        if (!createdId)
+        {
+            createdId = commands.createEntity();
+            commands.add<TestNonStackedComp>(createdId, 7);
+        }
+    });
+
+    // Nothing is applied until the sync point
+    assert(compsSet.size() == 4);
+    assert(!cm.contains<TestNonStackedComp>(createdId));
+    assert(!commands.empty());
+
+    commands.apply();
+
+    assert(commands.empty());
+    assert(compsSet.size() == 2);
+
+    auto [comps1, comps2, comps3, createdComps] = cm.get<TestNonStackedComp>(1, 2, 3, createdId);
+    assert(comps1.peek(&TestNonStackedComp::val) == 100);
+    assert(!comps2);
+    assert(!comps3);
+    assert(createdComps.peek(&TestNonStackedComp::val) == 7);
+
+    auto [stackedComps2, stackedComps3] = cm.get<TestStackedComp>(2, 3);
+    assert(stackedComps2.size() == 2);
+    assert(!stackedComps3);
+
+    commands.destroyEntity(createdId);
+    commands.apply();
+
+    assert(!cm.isAlive(createdId));
+    assert(!cm.contains<TestNonStackedComp>(createdId));
+
+    // A component which fails to construct records nothing, so later commands of its type apply once
+    struct ThrowingStackedComp : Stack
+    {
+        int val{};
+
+        ThrowingStackedComp(int _val) : val(_val)
+        {
+            if (_val < 0)
+                throw std::runtime_error("Failed component");
+        }
+    };
+
+    bool threw{};
+    try
+    {
+        commands.add<ThrowingStackedComp>(EntityId{1}, -1);
+    }
+    catch (const std::runtime_error &)
+    {
+        threw = true;
+    }
+    assert(threw);
+
+    commands.add<ThrowingStackedComp>(EntityId{1}, 1);
+    commands.add<ThrowingStackedComp>(EntityId{1}, 2);
+    commands.apply();
+
+    auto [throwingComps] = cm.get<ThrowingStackedComp>(EntityId{1});
+    assert(throwingComps.size() == 2);
+}
+
+inline void test_group_intersection_order(CM &cm)
+{
+    PRINT("TESTING GROUP INTERSECTION ORDER")
+
+    for (EntityId id = 1; id <= 10; ++id)
+        cm.add<TestNonStackedComp>(id, id);
+
+    // The smallest set drives the intersection, so its dense order is kept
+    std::vector<EntityId> stackedIds{9, 2, 7, 4, 11};
+    for (const auto &id : stackedIds)
+        cm.add<TestStackedComp>(id, id);
+
+    auto [comps7] = cm.get<TestStackedComp>(7);
+    comps7.remove([&](const TestStackedComp &_) { return true; });
+
+    std::vector<EntityId> expected{9, 2, 4};
+
+    auto ids = cm.getEntityIds<TestNonStackedComp, TestStackedComp>();
+    assert(ids == expected);
+
+    std::vector<EntityId> fromEach;
+    auto group = cm.getGroup<TestNonStackedComp, TestStackedComp>();
+    group.each([&](EId eId, auto &nonStackedComps, auto &stackedComps) {
+        assert(nonStackedComps.peek(&TestNonStackedComp::val) == static_cast<int>(eId));
+        fromEach.push_back(eId);
+    });
+
+    assert(fromEach == expected);
+    assert(!(cm.getGroup<TestNonStackedComp, TestEventComp>()));
+}
+
+inline void test_owning_group(CM &cm)
+{
+    PRINT("TESTING OWNING GROUP")
+
+    for (EntityId id = 1; id <= 20; ++id)
+    {
+        cm.add<TestNonStackedComp>(id, id);
+        if (id % 2 == 0)
+            cm.add<TestStackedComp>(id, id);
+    }
+
+    auto &group = cm.getOwningGroup<TestNonStackedComp, TestStackedComp>();
+    assert(group.size() == 10);
+    assert((&group == &cm.getOwningGroup<TestNonStackedComp, TestStackedComp>()));
+
+    auto checkGroup = [&](std::unordered_set<EntityId> expected) {
+        std::unordered_set<EntityId> fromEach;
+        group.each([&](EId eId, auto &nonStackedComps, auto &stackedComps) {
+            assert(nonStackedComps.peek(&TestNonStackedComp::val) == static_cast<int>(eId));
+            stackedComps.inspect([&](const TestStackedComp &comp) { assert(comp.val == static_cast<int>(eId)); });
+            fromEach.insert(eId);
+        });
+
+        auto ids = group.getIds();
+        assert(fromEach == expected);
+        assert((std::unordered_set<EntityId>(ids.begin(), ids.end()) == expected));
+        assert(group.size() == expected.size());
+    };
+
+    checkGroup({2, 4, 6, 8, 10, 12, 14, 16, 18, 20});
+
+    cm.add<TestStackedComp>(3, 3);
+    cm.remove<TestNonStackedComp>(4);
+    cm.remove(EntityId{6});
+    checkGroup({2, 3, 8, 10, 12, 14, 16, 18, 20});
+
+    // Sparse lookups still find components which the group moved around
+    for (EntityId id = 1; id <= 20; ++id)
+    {
+        auto [comps] = cm.get<TestNonStackedComp>(id);
+        if (comps)
+            assert(comps.peek(&TestNonStackedComp::val) == static_cast<int>(id));
+    }
+
+    int visited{};
+    group.each([&](EId eId, auto &nonStackedComps, auto &stackedComps) { return ++visited < 3; });
+    assert(visited == 3);
+
+    bool threw{};
+    try
+    {
+        auto &_ = cm.getOwningGroup<TestStackedComp, TestEventComp>();
+    }
+    catch (const std::runtime_error &)
+    {
+        threw = true;
+    }
+    assert(threw);
+
+    cm.clear<TestStackedComp>();
+    assert(!group);
+
+    cm.add<TestStackedComp>(2, 2);
+    checkGroup({2});
+}
+
+inline void test_grouping_ids_leave_component_ids_dense(CM &cm)
+{
+    PRINT("TESTING GROUPING IDS LEAVE COMPONENT IDS DENSE")
+
+    struct FirstNewComp
+    {
+    };
+    struct SecondNewComp
+    {
+    };
+
+    cm.add<TestNonStackedComp>(1, 1);
+    cm.add<TestStackedComp>(1, 1);
+
+    auto firstId = ECS::internal::Utilities::getTypeId<FirstNewComp>();
+
+    (void)cm.getQuery<TestNonStackedComp, TestStackedComp>();
+    (void)cm.getOwningGroup<TestNonStackedComp, TestStackedComp>();
+    ECS::ArchetypeManager<EntityId> am;
+    (void)am.createEntity<TestNonStackedComp, TestStackedComp>();
+    (void)am.getGroup<TestNonStackedComp, TestStackedComp>().size();
+
+    assert(ECS::internal::Utilities::getTypeId<SecondNewComp>() == firstId + 1);
+}
+
+inline void test_cached_query(CM &cm)
+{
+    PRINT("TESTING CACHED QUERY")
+
+    for (EntityId id = 1; id <= 20; ++id)
+    {
+        cm.add<TestNonStackedComp>(id, id);
+        if (id % 2 == 0)
+            cm.add<TestStackedComp>(id, id);
+    }
+
+    auto &query = cm.getQuery<TestNonStackedComp, TestStackedComp>();
+    assert(query.size() == 10);
+    assert((&query == &cm.getQuery<TestNonStackedComp, TestStackedComp>()));
+
+    // Queries leave the set order alone, so they can share sets with an owning group
+    auto &group = cm.getOwningGroup<TestNonStackedComp, TestStackedComp>();
+
+    auto checkQuery = [&](std::unordered_set<EntityId> expected) {
+        std::unordered_set<EntityId> fromEach;
+        query.each([&](EId eId, auto &nonStackedComps, auto &stackedComps) {
+            assert(nonStackedComps.peek(&TestNonStackedComp::val) == static_cast<int>(eId));
+            fromEach.insert(eId);
+        });
+
+        const auto &ids = query.getIds();
+        assert(fromEach == expected);
+        assert((std::unordered_set<EntityId>(ids.begin(), ids.end()) == expected));
+        assert(query.size() == group.size());
+    };
+
+    checkQuery({2, 4, 6, 8, 10, 12, 14, 16, 18, 20});
+
+    // Changes are picked up on the next use, including ones which cancel out
+    cm.add<TestStackedComp>(3, 3);
+    cm.remove<TestNonStackedComp>(4);
+    cm.remove(EntityId{6});
+    cm.remove<TestStackedComp>(8);
+    cm.add<TestStackedComp>(8, 8);
+    checkQuery({2, 3, 8, 10, 12, 14, 16, 18, 20});
+
+    // A recycled index with a new version is not mistaken for the destroyed entity
+    auto created = cm.createEntity();
+    cm.add<TestNonStackedComp>(created, static_cast<int>(created));
+    cm.add<TestStackedComp>(created, 0);
+    checkQuery({2, 3, 8, 10, 12, 14, 16, 18, 20, created});
+
+    cm.destroyEntity(created);
+    auto recycled = cm.createEntity();
+    assert(recycled != created);
+    cm.add<TestNonStackedComp>(recycled, static_cast<int>(recycled));
+    cm.add<TestStackedComp>(recycled, 0);
+    checkQuery({2, 3, 8, 10, 12, 14, 16, 18, 20, recycled});
+
+    int visited{};
+    query.each([&](EId eId, auto &nonStackedComps, auto &stackedComps) { return ++visited < 3; });
+    assert(visited == 3);
+
+    cm.clear<TestStackedComp>();
+    assert(!query);
+
+    cm.add<TestStackedComp>(2, 2);
+    checkQuery({2});
+
+    // Churn past the size of the sets between uses falls back to a rebuild
+    for (int round = 0; round < 50; ++round)
+    {
+        for (EntityId id = 10; id <= 20; ++id)
+            cm.add<TestStackedComp>(id, static_cast<int>(id));
+        for (EntityId id = 10; id <= 20; ++id)
+            cm.remove<TestStackedComp>(id);
+    }
+    cm.add<TestStackedComp>(12, 12);
+    checkQuery({2, 12});
+
+    // Removed queries are created again from the current sets
+    cm.removeQuery<TestNonStackedComp, TestStackedComp>();
+    cm.add<TestStackedComp>(14, 14);
+    auto &recreated = cm.getQuery<TestNonStackedComp, TestStackedComp>();
+    const auto &recreatedIds = recreated.getIds();
+    assert((std::unordered_set<EntityId>(recreatedIds.begin(), recreatedIds.end()) ==
+            std::unordered_set<EntityId>{2, 12, 14}));
+}
+
+inline void test_parallel_each(CM &cm)
+{
+    PRINT("TESTING PARALLEL EACH")
+
+    constexpr int count = 1000;
+    ECS::ThreadPool pool{4};
+    assert(pool.size() == 4);
+
+    for (EntityId id = 1; id <= count; ++id)
+    {
+        cm.add<TestNonStackedComp>(id, 0);
+        if (id % 2 == 0)
+            cm.add<TestStackedComp>(id, 0);
+    }
+
+    // Every entity is visited once, whatever the chunk size
+    auto [nonStackedSet] = cm.getAll<TestNonStackedComp>();
+    for (size_t chunkSize : {1, 7, 64, 4096})
+    {
+        nonStackedSet.parallelEach(
+            pool,
+            [](EntityId eId, auto &comps) { comps.mutate([](TestNonStackedComp &comp) { comp.val++; }); },
+            chunkSize);
+    }
+
+    for (EntityId id = 1; id <= count; ++id)
+    {
+        auto [comps] = cm.get<TestNonStackedComp>(id);
+        assert(comps.peek(&TestNonStackedComp::val) == 4);
+    }
+
+    auto group = cm.getGroup<TestNonStackedComp, TestStackedComp>();
+    std::atomic<int> visited{};
+    group.parallelEach(
+        pool,
+        [&](EntityId eId, auto &nonStackedComps, auto &stackedComps) {
+            stackedComps.mutate([&](TestStackedComp &comp) { comp.val = static_cast<int>(eId); });
+            visited++;
+        },
+        16);
+
+    assert(visited == count / 2);
+    cm.getGroup<TestNonStackedComp, TestStackedComp>().each([](EntityId eId, auto &nonStackedComps, auto &stackedComps) {
+        stackedComps.inspect([&](const TestStackedComp &comp) { assert(comp.val == static_cast<int>(eId)); });
+    });
+
+    // Removed values are skipped, and pruned once the loop is done
+    auto [removed] = cm.get<TestNonStackedComp>(EntityId{3});
+    removed.remove([](const TestNonStackedComp &comp) { return true; });
+
+    visited = 0;
+    nonStackedSet.parallelEach(pool, [&](EntityId eId, auto &comps) { visited++; }, 8);
+    assert(visited == count - 1);
+#ifndef ecs_disable_auto_prune
+    assert(!cm.contains<TestNonStackedComp>(EntityId{3}));
+#endif
+
+    // Exceptions thrown by any chunk reach the caller once every chunk is done
+    bool threw{};
+    try
+    {
+        nonStackedSet.parallelEach(
+            pool,
+            [](EntityId eId, auto &comps) {
+                if (eId == 500)
+                    throw std::runtime_error("Failed chunk");
+            },
+            8);
+    }
+    catch (const std::runtime_error &)
+    {
+        threw = true;
+    }
+    assert(threw);
+
+    // The manager's own pool runs the same loops
+    visited = 0;
+    nonStackedSet.parallelEach(cm.getThreadPool(), [&](EntityId eId, auto &comps) { visited++; });
+    assert(visited == count - 1);
+
+    // Structural changes to a set being iterated in parallel are refused
+    auto sizeBefore = nonStackedSet.size();
+    nonStackedSet.parallelEach(pool, [&](EntityId eId, auto &comps) { cm.add<TestNonStackedComp>(eId + count, 0); }, 8);
+    assert(nonStackedSet.size() == sizeBefore);
+    assert(!cm.contains<TestNonStackedComp>(EntityId{count + 1}));
+
+    cm.add<TestNonStackedComp>(EntityId{count + 1}, 0);
+    assert(cm.contains<TestNonStackedComp>(EntityId{count + 1}));
+
+    // A chunk which runs another pool can still run its own pool inline afterwards
+    ECS::ThreadPool otherPool{2};
+    std::atomic<size_t> nestedVisited{};
+    pool.parallelFor(64, 1, [&](size_t begin, size_t end) {
+        otherPool.parallelFor(4, 1, [](size_t, size_t) {});
+        pool.parallelFor(4, 1, [&](size_t nestedBegin, size_t nestedEnd) { nestedVisited += nestedEnd - nestedBegin; });
+    });
+    assert(nestedVisited == 64 * 4);
+}
+
+inline void test_scheduler(CM &cm)
+{
+    PRINT("TESTING SCHEDULER")
+
+    using ECS::Read;
+    using ECS::Write;
+
+    constexpr int count = 100;
+    cm.setThreadPool(std::make_shared<ECS::ThreadPool>(4));
+
+    for (EntityId id = 1; id <= count; ++id)
+    {
+        cm.add<TestVelocityComponent>(id);
+        cm.add<TestPositionComponent>(id);
+        cm.add<TestNonStackedComp>(id, 0);
+    }
+
+    ECS::Scheduler<EntityId> scheduler{cm};
+    std::atomic<int> stackedBeforeSync{-1};
+    std::atomic<int> stackedAfterSync{-1};
+    std::atomic<int> velocityReads{};
+
+    // Conflicting writes run in registration order
+    scheduler.addSystem<Read<TestVelocityComponent>, Write<TestPositionComponent>>(
+        [](CM &cm, ECS::CommandBuffer<EntityId> &commands) {
+            cm.getGroup<TestVelocityComponent, TestPositionComponent>().each(
+                [](EId eId, auto &velComps, auto &posComps) {
+                    velComps.inspect([&](const TestVelocityComponent &vel) {
+                        posComps.mutate([&](TestPositionComponent &pos) { pos.x += vel.x; });
+                    });
+                });
+        });
+
+    scheduler.addSystem<Write<TestPositionComponent>>([](CM &cm, ECS::CommandBuffer<EntityId> &commands) {
+        cm.getGroup<TestPositionComponent>().each([](EId eId, auto &posComps) {
+            posComps.mutate([](TestPositionComponent &pos) { pos.x *= 10.0f; });
+        });
+    });
+
+    scheduler.addSystem<Read<TestVelocityComponent>>([&](CM &cm, ECS::CommandBuffer<EntityId> &commands) {
+        velocityReads += static_cast<int>(cm.getGroup<TestVelocityComponent>().size());
+    });
+
+    // Structural changes are deferred to the next sync point
+    scheduler.addSystem<Write<TestNonStackedComp>>([](CM &cm, ECS::CommandBuffer<EntityId> &commands) {
+        cm.getGroup<TestNonStackedComp>().each([&](EId eId, auto &comps) {
+            comps.mutate([](TestNonStackedComp &comp) { comp.val++; });
+            commands.add<TestStackedComp>(eId, static_cast<int>(eId));
+        });
+    });
+
+    scheduler.addSystem<Read<TestStackedComp>>([&](CM &cm, ECS::CommandBuffer<EntityId> &commands) {
+        stackedBeforeSync = static_cast<int>(cm.getGroup<TestStackedComp>().size());
+    });
+
+    scheduler.addSyncPoint();
+
+    scheduler.addSystem<Read<TestStackedComp>>([&](CM &cm, ECS::CommandBuffer<EntityId> &commands) {
+        stackedAfterSync = static_cast<int>(cm.getGroup<TestStackedComp>().size());
+    });
+
+    assert(scheduler.size() == 6);
+    scheduler.run();
+
+    assert(stackedBeforeSync == 0);
+    assert(stackedAfterSync == count);
+    assert(velocityReads == count);
+
+    auto checkPositions = [&](float expected) {
+        for (EntityId id = 1; id <= count; ++id)
+        {
+            auto [posComps] = cm.get<TestPositionComponent>(id);
+            assert(posComps.peek(&TestPositionComponent::x) == expected);
+        }
+    };
+    checkPositions(10.0f);
+
+    // Disabled systems are skipped
+    scheduler.setEnabled(1, false);
+    scheduler.run();
+    checkPositions(11.0f);
+    assert(velocityReads == count * 2);
+
+    // Exceptions reach the caller, and the frame's commands are dropped
+    scheduler.addSystem<Write<TestEventComp>>([](CM &cm, ECS::CommandBuffer<EntityId> &commands) {
+        commands.add<TestEventComp>(EntityId{1});
+        throw std::runtime_error("Failed system");
+    });
+
+    bool threw{};
+    try
+    {
+        scheduler.run();
+    }
+    catch (const std::runtime_error &)
+    {
+        threw = true;
+    }
+    assert(threw);
+    assert(!cm.contains<TestEventComp>(EntityId{1}));
+}
+
+template <typename T>
+concept CanMutateConstView =
+    requires(const ECS::Components<T> &comps) { comps.mutate([](T &) {}); } ||
+    requires(const ECS::Components<T> &comps) { comps.filter([](const T &) { return true; }).mutate([](T &) {}); } ||
+    requires(const ECS::Components<T> &comps) { comps.find([](const T &) { return true; }).mutate([](T &) {}); } ||
+    requires(const ECS::Components<T> &comps) { comps.first().mutate([](T &) {}); } ||
+    requires(const ECS::Components<T> &comps) { comps.last().mutate([](T &) {}); } ||
+    requires(const ECS::Components<T> &comps) {
+        comps.sort([](const T &, const T &) { return true; }).mutate([](T &) {});
+    } || requires(const ECS::Components<T> &comps) {
+        comps.filter([](const T &) { return true; }).remove([](const T &) { return true; });
+    } || requires(const ECS::Components<T> &comps) {
+        comps.filter([](const T &) { return true; }).first().mutate([](T &) {});
+    };
+
+template <typename T>
+concept CanMutateDerivedView = requires(ECS::Components<T> &comps) {
+    comps.filter([](const T &) { return true; }).mutate([](T &) {});
+};
+
+inline void test_read_only_iteration(CM &cm)
+{
+    PRINT("TESTING READ-ONLY ITERATION")
+
+    static_assert(!CanMutateConstView<TestNonStackedComp>);
+    static_assert(!CanMutateConstView<TestStackedComp>);
+    static_assert(CanMutateDerivedView<TestNonStackedComp>);
+
+    for (EntityId id = 1; id <= 10; ++id)
+    {
+        cm.add<TestNonStackedComp>(id, id);
+        cm.add<TestStackedComp>(id, id);
+    }
+
+    auto [removed] = cm.get<TestNonStackedComp>(EntityId{3});
+    removed.remove([](const TestNonStackedComp &comp) { return true; });
+
+    auto [nonStackedSet] = cm.getAll<TestNonStackedComp>();
+    const auto &constSet = nonStackedSet;
+
+    // Empty values are skipped without being pruned
+    int visited{};
+    constSet.each([&](EntityId eId, const auto &comps) {
+        assert(eId != 3);
+        assert(comps.peek(&TestNonStackedComp::val) == static_cast<int>(eId));
+        visited++;
+    });
+    assert(visited == 9);
+    assert(constSet.getIds().size() == 10);
+
+    visited = 0;
+    constSet.each([&](EntityId eId, const auto &comps) { return ++visited < 4; });
+    assert(visited == 4);
+
+    auto group = cm.getGroup<TestNonStackedComp, TestStackedComp>();
+    visited = 0;
+    group.inspectEach([&](EntityId eId, const auto &nonStackedComps, const auto &stackedComps) {
+        stackedComps.inspect([&](const TestStackedComp &comp) { assert(comp.val == static_cast<int>(eId)); });
+        visited++;
+    });
+    assert(visited == 9);
+    assert(constSet.getIds().size() == 10);
+
+    visited = 0;
+    group.inspectEach([&](EntityId eId, const auto &nonStackedComps, const auto &stackedComps) {
+        return ++visited < 2;
+    });
+    assert(visited == 2);
+
+    // Filtered and narrowed components of a const view can still be read
+    auto [stacked] = cm.get<TestStackedComp>(EntityId{5});
+    cm.add<TestStackedComp>(EntityId{5}, 50);
+    const auto &constStacked = stacked;
+    auto filtered = constStacked.filter([](const TestStackedComp &comp) { return comp.val > 10; });
+    int firstVal{};
+    filtered.first().inspect([&](const TestStackedComp &comp) { firstVal = comp.val; });
+    assert(firstVal == 50);
+    assert(!constStacked.filter([](const TestStackedComp &comp) { return comp.val > 100; }));
+
+    // Pruning is an explicit step
+    nonStackedSet.prune();
+    assert(constSet.getIds().size() == 9);
+    assert(!cm.contains<TestNonStackedComp>(EntityId{3}));
+}
+
+inline void test_chunked_iteration(CM &cm)
+{
+    PRINT("TESTING CHUNKED ITERATION")
+
+    constexpr int count = 100;
+    for (EntityId id = 1; id <= count; ++id)
+    {
+        cm.add<TestVelocityComponent>(id, static_cast<float>(id), 1.0f);
+        cm.add<TestPositionComponent>(id);
+    }
+
+    auto [removed] = cm.get<TestVelocityComponent>(EntityId{50});
+    removed.remove([](const TestVelocityComponent &vel) { return true; });
+
+    // Chunks follow the dense order, skip empty values, and respect the chunk size
+    auto [velSet] = cm.getAll<TestVelocityComponent>();
+    std::vector<EntityId> visited;
+    velSet.eachChunk(
+        [&](std::span<const EntityId> ids, std::span<TestVelocityComponent> vels) {
+            assert(ids.size() == vels.size());
+            assert(ids.size() <= 16);
+            for (size_t i = 0; i < ids.size(); ++i)
+            {
+                assert(vels[i].x == static_cast<float>(ids[i]));
+                visited.push_back(ids[i]);
+            }
+        },
+        16);
+
+    assert(visited.size() == count - 1);
+    assert(std::find(visited.begin(), visited.end(), EntityId{50}) == visited.end());
+
+    size_t chunks{};
+    std::as_const(velSet).eachChunk(
+        [&](std::span<const EntityId> ids, std::span<const TestVelocityComponent> vels) { return ++chunks < 2; },
+        16);
+    assert(chunks == 2);
+
+    auto &group = cm.getOwningGroup<TestPositionComponent, TestVelocityComponent>();
+    assert(group.size() == count);
+
+    constexpr float dt = 0.5f;
+    size_t moved{};
+    group.eachChunk([&](std::span<const EntityId> ids, std::span<TestPositionComponent> positions,
+                        std::span<TestVelocityComponent> velocities) {
+        for (size_t i = 0; i < ids.size(); ++i)
+        {
+            positions[i].x += velocities[i].x * dt;
+            positions[i].y += velocities[i].y * dt;
+        }
+        moved += ids.size();
+    });
+    assert(moved == count - 1);
+
+    for (EntityId id = 1; id <= count; ++id)
+    {
+        auto [posComps] = cm.get<TestPositionComponent>(id);
+        auto expected = id == 50 ? 0.0f : static_cast<float>(id) * dt;
+        assert(posComps.peek(&TestPositionComponent::x) == expected);
+    }
+}
+
+
+inline void test_archetype_manager(CM &cm)
+{
+    PRINT("TESTING ARCHETYPE MANAGER")
+
+    using Manager = ECS::ArchetypeManager<EntityId>;
+    Manager am;
+
+    constexpr int count = 100;
+    std::vector<EntityId> ids;
+    for (int i = 0; i < count; ++i)
+    {
+        auto id = am.createEntity();
+        ids.push_back(id);
+        am.add<TestVelocityComponent>(id, static_cast<float>(i), 1.0f);
+        if (i % 2 == 0)
+            am.add<TestPositionComponent>(id);
+    }
+
+    // One table per set of types, plus the empty root table
+    assert(am.getTableCount() == 3);
+    assert(am.getGroup<TestVelocityComponent>().size() == count);
+    assert(am.getGroup<TestPositionComponent>().size() == count / 2);
+    assert((am.contains<TestVelocityComponent, TestPositionComponent>(ids[0])));
+    assert(!(am.contains<TestVelocityComponent, TestPositionComponent>(ids[1])));
+
+    // Moving table keeps the components of the entity
+    for (int i = 0; i < count; ++i)
+    {
+        auto [velComps] = am.get<TestVelocityComponent>(ids[i]);
+        assert(velComps.peek(&TestVelocityComponent::x) == static_cast<float>(i));
+    }
+
+    constexpr float dt = 0.5f;
+    size_t moved{};
+    auto group = am.getGroup<TestPositionComponent, TestVelocityComponent>();
+    group.each([&](EId eId, auto &posComps, auto &velComps) {
+        velComps.inspect([&](const TestVelocityComponent &vel) {
+            posComps.mutate([&](TestPositionComponent &pos) { pos.x += vel.x * dt; });
+        });
+        ++moved;
+    });
+    assert(moved == count / 2);
+
+    auto [posComps] = am.get<TestPositionComponent>(ids[10]);
+    assert(posComps.peek(&TestPositionComponent::x) == 10.0f * dt);
+
+    // Removing a type moves the entity back, and swaps another row into its place
+    am.remove<TestPositionComponent>(ids[0]);
+    assert(!am.contains<TestPositionComponent>(ids[0]));
+    assert(am.contains<TestVelocityComponent>(ids[0]));
+    assert(am.getEntityIds<TestPositionComponent>().size() == count / 2 - 1);
+    for (int i = 2; i < count; i += 2)
+    {
+        auto [pos, vel] = am.get<TestPositionComponent, TestVelocityComponent>(ids[i]);
+        assert(pos.peek(&TestPositionComponent::x) == static_cast<float>(i) * dt);
+        assert(vel.peek(&TestVelocityComponent::x) == static_cast<float>(i));
+    }
+
+    am.overwrite<TestVelocityComponent>(ids[3], 42.0f, 0.0f);
+    auto [overwritten] = am.get<TestVelocityComponent>(ids[3]);
+    assert(overwritten.peek(&TestVelocityComponent::x) == 42.0f);
+
+    // Stacked components move as a whole stack
+    am.add<TestDamageComponent>(ids[5], 1);
+    am.add<TestDamageComponent>(ids[5], 2);
+    am.add<TestPositionComponent>(ids[5]);
+    auto [damages] = am.get<TestDamageComponent>(ids[5]);
+    assert(damages.size() == 2);
+    int totalDamage{};
+    damages.inspect([&](const TestDamageComponent &damage) { totalDamage += damage.amount; });
+    assert(totalDamage == 3);
+
+    // Destroyed ids no longer find the components of their recycled index
+    am.destroyEntity(ids[5]);
+    assert(!am.isAlive(ids[5]));
+    assert(!am.contains<TestVelocityComponent>(ids[5]));
+    auto recycled = am.createEntity();
+    assert(!am.contains<TestVelocityComponent>(recycled));
+    assert(am.getGroup<TestVelocityComponent>().size() == count - 1);
+
+    // Adding through the stale id leaves the entity which reuses its index in place
+    am.add<TestVelocityComponent>(recycled, 7.0f, 0.0f);
+    am.add<TestVelocityComponent>(ids[5], 8.0f, 0.0f);
+    assert(am.contains<TestVelocityComponent>(recycled));
+    assert(!am.contains<TestVelocityComponent>(ids[5]));
+    assert(am.getGroup<TestVelocityComponent>().size() == count);
+    auto [recycledVel] = am.get<TestVelocityComponent>(recycled);
+    assert(recycledVel.peek(&TestVelocityComponent::x) == 7.0f);
+
+    size_t visited{};
+    auto velGroup = am.getGroup<TestVelocityComponent>();
+    velGroup.inspectEach([&](EId eId, const auto &velComps) { return ++visited < 10; });
+    assert(visited == 10);
+}
+
+inline void test_add_bulk(CM &cm)
+{
+    PRINT("TESTING BULK ADD")
+
+    constexpr int count = 3000;
+    std::vector<EntityId> ids;
+    for (EntityId id = 1; id <= count; ++id)
+        ids.push_back(id);
+
+    cm.addBulk<TestVelocityComponent>(ids, 2.0f, 3.0f);
+
+    std::vector<TestPositionComponent> positions(count);
+    for (int i = 0; i < count; ++i)
+        positions[i].x = static_cast<float>(ids[i]);
+    cm.addBulk<TestPositionComponent>(ids, std::span<const TestPositionComponent>(positions));
+
+    assert((cm.getGroup<TestVelocityComponent, TestPositionComponent>().size() == count));
+    for (const auto &id : ids)
+    {
+        assert((cm.contains<TestVelocityComponent, TestPositionComponent>(id)));
+        auto [vel, pos] = cm.get<TestVelocityComponent, TestPositionComponent>(id);
+        assert(vel.peek(&TestVelocityComponent::y) == 3.0f);
+        assert(pos.peek(&TestPositionComponent::x) == static_cast<float>(id));
+    }
+
+    // Ids which already have a stacked component get another, and id 0 is skipped like with add
+    std::vector<EntityId> stackedIds{0, 5, 6, 5};
+    cm.addBulk<TestDamageComponent>(stackedIds, 1);
+    auto [damages] = cm.get<TestDamageComponent>(EntityId{5});
+    assert(damages.size() == 2);
+    auto [otherDamages] = cm.get<TestDamageComponent>(EntityId{6});
+    assert(otherDamages.size() == 1);
+    assert(!cm.contains<TestDamageComponent>(EntityId{0}));
+
+    // Non-stacked components are not added twice
+    cm.addBulk<TestNonStackedComp>(std::vector<EntityId>{7, 7}, 1);
+    auto [nonStacked] = cm.get<TestNonStackedComp>(EntityId{7});
+    assert(nonStacked.size() == 1);
+
+    bool threw{false};
+    try
+    {
+        cm.addBulk<TestPositionComponent>(ids, std::span<const TestPositionComponent>(positions).first(1));
+    }
+    catch (const std::runtime_error &)
+    {
+        threw = true;
+    }
+    assert(threw);
+}
+
+inline void test_entity_builder(CM &cm)
+{
+    PRINT("TESTING ENTITY BUILDER")
+
+    auto eId = cm.createEntity<TestVelocityComponent, TestPositionComponent, TestHealthComponent>(
+        std::tuple{2.0f, 3.0f}, std::tuple{}, std::tuple{7});
+    assert(cm.isAlive(eId));
+    auto [vel, pos, health] = cm.get<TestVelocityComponent, TestPositionComponent, TestHealthComponent>(eId);
+    assert(vel.peek(&TestVelocityComponent::y) == 3.0f);
+    assert(pos.peek(&TestPositionComponent::x) == 0.0f);
+    assert(health.peek(&TestHealthComponent::value) == 7);
+
+    constexpr int count = 500;
+    auto ids = cm.createEntities<TestVelocityComponent, TestPositionComponent>(count);
+    assert(ids.size() == count);
+    assert((cm.getGroup<TestVelocityComponent, TestPositionComponent>().size() == count + 1));
+    for (const auto &id : ids)
+        assert((cm.contains<TestVelocityComponent, TestPositionComponent>(id)));
+
+    auto healthy = cm.createEntities<TestHealthComponent>(count, std::tuple{5});
+    auto [lastHealth] = cm.get<TestHealthComponent>(healthy.back());
+    assert(lastHealth.peek(&TestHealthComponent::value) == 5);
+
+    // Ids whose index is already stored, directly or through another generation, are not added a second time
+    using Entity = ECS::internal::EntityTraits<EntityId>;
+    auto destroyed = cm.createEntity();
+    cm.destroyEntity(destroyed);
+    auto recycled = Entity::nextVersion(destroyed);
+    cm.add<TestHealthComponent>(recycled, 1);
+
+    auto healthCount = cm.getEntityIds<TestHealthComponent>().size();
+    assert(cm.createEntity<TestHealthComponent>(std::tuple{2}) == recycled);
+    assert(cm.getEntityIds<TestHealthComponent>().size() == healthCount);
+    auto [recycledHealth] = cm.get<TestHealthComponent>(recycled);
+    assert(recycledHealth.peek(&TestHealthComponent::value) == 1);
+
+    destroyed = cm.createEntity();
+    cm.destroyEntity(destroyed);
+    cm.add<TestHealthComponent>(destroyed, 3);
+
+    healthCount = cm.getEntityIds<TestHealthComponent>().size();
+    auto created = cm.createEntity<TestHealthComponent>(std::tuple{4});
+    assert(created == Entity::nextVersion(destroyed));
+    assert(cm.getEntityIds<TestHealthComponent>().size() == healthCount);
+    assert(!cm.contains<TestHealthComponent>(created));
+    assert(cm.contains<TestHealthComponent>(destroyed));
+
+    ECS::ArchetypeManager<EntityId> am;
+    auto tableId =
+        am.createEntity<TestVelocityComponent, TestPositionComponent>(std::tuple{4.0f, 1.0f}, std::tuple{});
+    auto tableIds = am.createEntities<TestPositionComponent, TestVelocityComponent>(count);
+
+    // Both orders of the types share a single table, next to the empty root table
+    assert(am.getTableCount() == 2);
+    assert(am.getGroup<TestVelocityComponent>().size() == count + 1);
+    auto [tableVel] = am.get<TestVelocityComponent>(tableId);
+    assert(tableVel.peek(&TestVelocityComponent::x) == 4.0f);
+
+    am.remove<TestPositionComponent>(tableIds.front());
+    assert(!am.contains<TestPositionComponent>(tableIds.front()));
+    assert(am.contains<TestVelocityComponent>(tableIds.back()));
+}
+
+inline void test_clone(CM &cm)
+{
+    PRINT("TESTING CLONE")
+
+    // Reserved ids make handy prefabs, since they are never handed out to systems
+    constexpr EntityId prefab = 1;
+    cm.add<TestVelocityComponent>(prefab, 2.0f, 3.0f);
+    cm.add<TestDamageComponent>(prefab, 4);
+    cm.add<TestDamageComponent>(prefab, 5);
+    cm.add<TestNonStackedComp>(prefab, 6);
+    cm.add<TestPositionComponent>(prefab);
+    cm.remove<TestPositionComponent>(prefab);
+
+    constexpr int count = 300;
+    auto ids = cm.clone(prefab, count);
+    assert(ids.size() == count);
+    assert((cm.getGroup<TestVelocityComponent, TestDamageComponent>().size() == count + 1));
+    assert(!cm.contains<TestPositionComponent>(ids.front()));
+
+    for (const auto &id : ids)
+    {
+        auto [vel, damages, nonStacked] =
+            cm.get<TestVelocityComponent, TestDamageComponent, TestNonStackedComp>(id);
+        assert(vel.peek(&TestVelocityComponent::y) == 3.0f);
+        assert(damages.size() == 2);
+        assert(nonStacked.peek(&TestNonStackedComp::val) == 6);
+        assert(nonStacked.peek(&TestNonStackedComp::message) == "this is a non-stacked component");
+    }
+
+    // Copies are independent of the prefab and of each other
+    auto [cloneVel] = cm.get<TestVelocityComponent>(ids[0]);
+    cloneVel.mutate([](TestVelocityComponent &vel) { vel.x = 10.0f; });
+    auto [prefabVel, otherVel] = cm.get<TestVelocityComponent>(prefab, ids[1]);
+    assert(prefabVel.peek(&TestVelocityComponent::x) == 2.0f);
+    assert(otherVel.peek(&TestVelocityComponent::x) == 2.0f);
+
+    auto single = cm.clone(ids[0]);
+    auto [singleVel] = cm.get<TestVelocityComponent>(single);
+    assert(singleVel.peek(&TestVelocityComponent::x) == 10.0f);
+
+    // Targets which already store a component keep it, and the set gains no extra copy
+    using Entity = ECS::internal::EntityTraits<EntityId>;
+    auto destroyed = cm.createEntity();
+    cm.destroyEntity(destroyed);
+    auto recycled = Entity::nextVersion(destroyed);
+    cm.add<TestNonStackedComp>(recycled, 9);
+
+    auto nonStackedCount = cm.getEntityIds<TestNonStackedComp>().size();
+    assert(cm.clone(prefab) == recycled);
+    assert(cm.getEntityIds<TestNonStackedComp>().size() == nonStackedCount);
+    auto [recycledNonStacked, recycledVel] = cm.get<TestNonStackedComp, TestVelocityComponent>(recycled);
+    assert(recycledNonStacked.peek(&TestNonStackedComp::val) == 9);
+    assert(recycledVel.peek(&TestVelocityComponent::x) == 2.0f);
+
+    auto [nonStackedSet] = cm.getAll<TestNonStackedComp>();
+    size_t visited{};
+    nonStackedSet.each([&](EId eId, auto &comps) { ++visited; });
+    assert(visited == nonStackedCount);
+
+    ECS::ArchetypeManager<EntityId> am;
+    am.add<TestVelocityComponent>(prefab, 2.0f, 3.0f);
+    am.add<TestDamageComponent>(prefab, 4);
+    auto tableIds = am.clone(prefab, count);
+    assert((am.getGroup<TestVelocityComponent, TestDamageComponent>().size() == count + 1));
+    auto [tableDamages] = am.get<TestDamageComponent>(tableIds.back());
+    assert(tableDamages.size() == 1);
+}
+
+inline void test_change_ticks(CM &cm)
+{
+    PRINT("TESTING CHANGE TICKS")
+
+    constexpr int count = 100;
+    for (EntityId id = 1; id <= count; ++id)
+    {
+        cm.add<TestVelocityComponent>(id);
+        cm.add<TestPositionComponent>(id);
+    }
+
+    auto collectChanged = [&](ECS::internal::ChangeTick tick) {
+        std::vector<EntityId> changed;
+        auto [velSet] = cm.getAll<TestVelocityComponent>();
+        std::as_const(velSet).eachChangedSince(tick, [&](EId eId, const auto &velComps) { changed.push_back(eId); });
+        return changed;
+    };
+
+    // Everything was added at or after tick 0
+    assert(collectChanged(0).size() == count);
+
+    auto lastSync = cm.advanceTick();
+    assert(lastSync == cm.getTick());
+    assert(collectChanged(lastSync).empty());
+
+    // Mutate, overwrite, and add each stamp the current tick
+    auto [mutated] = cm.get<TestVelocityComponent>(EntityId{10});
+    mutated.mutate([](TestVelocityComponent &vel) { vel.x = 5.0f; });
+    cm.overwrite<TestVelocityComponent>(EntityId{20}, 1.0f, 2.0f);
+    cm.add<TestVelocityComponent>(EntityId{count + 1});
+
+    // Reading leaves the tick alone
+    auto [inspected] = cm.get<TestVelocityComponent>(EntityId{30});
+    inspected.inspect([](const TestVelocityComponent &vel) {});
+
+    auto changed = collectChanged(lastSync);
+    std::sort(changed.begin(), changed.end());
+    assert((changed == std::vector<EntityId>{10, 20, count + 1}));
+    assert(mutated.hasChangedSince(lastSync));
+    assert(!inspected.hasChangedSince(lastSync));
+
+    // Changes after the read are seen by the next read, and nothing is seen twice
+    lastSync = cm.advanceTick();
+    auto [later] = cm.get<TestVelocityComponent>(EntityId{40});
+    later.mutate([](TestVelocityComponent &vel) { vel.y = 3.0f; });
+    assert((collectChanged(lastSync) == std::vector<EntityId>{40}));
+
+    // Groups only look up the rest of the components for entities whose type changed
+    lastSync = cm.advanceTick();
+    auto [pos] = cm.get<TestPositionComponent>(EntityId{50});
+    pos.mutate([](TestPositionComponent &pos) { pos.x = 1.0f; });
+
+    std::vector<EntityId> groupChanged;
+    auto group = cm.getGroup<TestVelocityComponent, TestPositionComponent>();
+    group.eachChangedSince<TestPositionComponent>(lastSync, [&](EId eId, auto &velComps, auto &posComps) {
+        groupChanged.push_back(eId);
+    });
+    assert((groupChanged == std::vector<EntityId>{50}));
+
+    // Chunks are handed out for writing, so they count as changed
+    lastSync = cm.advanceTick();
+    auto [posSet] = cm.getAll<TestPositionComponent>();
+    posSet.eachChunk([](std::span<const EId> ids, std::span<TestPositionComponent> positions) {});
+    size_t chunkChanged{};
+    posSet.eachChangedSince(lastSync, [&](EId eId, auto &posComps) { ++chunkChanged; });
+    assert(chunkChanged == count);
+
+    // Mutating through filtered components stamps the slot they were taken from
+    lastSync = cm.advanceTick();
+    auto [filtered] = cm.get<TestVelocityComponent>(EntityId{60});
+    filtered.filter([](const TestVelocityComponent &vel) { return true; })
+        .mutate([](TestVelocityComponent &vel) { vel.x = 100.0f; });
+    assert(filtered.peek(&TestVelocityComponent::x) == 100.0f);
+    assert(filtered.hasChangedSince(lastSync));
+    assert((collectChanged(lastSync) == std::vector<EntityId>{60}));
+}
+
+inline void test_component_events(CM &cm)
+{
+    PRINT("TESTING COMPONENT EVENTS")
+
+    // Types which are not observed have nothing to drain
+    assert(!cm.drainEvents<TestVelocityComponent>([](const auto &events) { assert(false); }));
+
+    cm.observe<TestVelocityComponent>();
+    for (EntityId id = 1; id <= 10; ++id)
+        cm.add<TestVelocityComponent>(id);
+
+    // Adding to an entity which already has the component is not an add event
+    cm.add<TestPositionComponent>(EntityId{1});
+    cm.add<TestVelocityComponent>(EntityId{1});
+
+    cm.overwrite<TestVelocityComponent>(EntityId{2}, 1.0f, 1.0f);
+    cm.remove<TestVelocityComponent>(EntityId{3});
+    cm.destroyEntity(EntityId{4});
+
+    auto batch = cm.createEntities<TestVelocityComponent>(5);
+    auto cloned = cm.clone(EntityId{5});
+
+    bool drained{false};
+    cm.drainEvents<TestVelocityComponent>([&](const ECS::ComponentEvents<EntityId> &events) {
+        assert(events.added.size() == 10 + batch.size() + 1);
+        assert(events.added.back() == cloned);
+        assert((events.removed == std::vector<EntityId>{3, 4}));
+        assert((events.overwritten == std::vector<EntityId>{2}));
+        drained = true;
+    });
+    assert(drained);
+
+    // Draining clears the queue
+    cm.drainEvents<TestVelocityComponent>([](const auto &events) { assert(events.empty()); });
+
+    // Components removed through a wrapper are reported once the set is pruned
+    auto [velComps] = cm.get<TestVelocityComponent>(EntityId{6});
+    velComps.remove([](const TestVelocityComponent &vel) { return true; });
+    cm.prune<TestVelocityComponent>();
+    cm.clear<TestVelocityComponent>();
+
+    size_t removed{};
+    cm.drainEvents<TestVelocityComponent>([&](const auto &events) {
+        assert(events.added.empty());
+        assert(events.removed.front() == 6);
+        removed = events.removed.size();
+    });
+    assert(removed == 8 + batch.size() + 1);
+
+    // The queue survives the set being emptied
+    cm.add<TestVelocityComponent>(EntityId{7});
+    cm.drainEvents<TestVelocityComponent>(
+        [](const auto &events) { assert((events.added == std::vector<EntityId>{7})); });
+}
+
+inline void test_transformation_pipeline(CM &cm)
+{
+    PRINT("TESTING TRANSFORMATION PIPELINE")
+
+    using ECS::internal::Transformation;
+
+    // Registered before the component's set exists, with a component which is not trivially copyable
+    cm.registerTransformation<TestTransformComp>([](EntityId eId, TestTransformComp comp) {
+        comp.message += " of " + std::to_string(eId);
+        return comp;
+    });
+
+    for (EntityId id = 1; id <= 3; ++id)
+        cm.add<TestTransformComp>(id);
+
+    // Transform tagged components are transformed by default
+    auto [comps2] = cm.get<TestTransformComp>(EntityId{2});
+    assert(comps2.peek(&TestTransformComp::message) == "this is a transform component of 2");
+    assert(comps2.peek(Transformation::PRESERVE, &TestTransformComp::message) ==
+           "this is a transform component");
+
+    // Registering again replaces the pipeline of the existing set
+    cm.registerTransformation<TestTransformComp>([](EntityId eId, TestTransformComp comp) {
+        comp.message = std::to_string(eId * 10);
+        return comp;
+    });
+    auto [comps3] = cm.get<TestTransformComp>(EntityId{3});
+    assert(comps3.peek(&TestTransformComp::message) == "30");
+
+    // A set created again after being cleared keeps the registered pipeline
+    cm.clear<TestTransformComp>();
+    cm.add<TestTransformComp>(EntityId{4});
+    auto [comps4] = cm.get<TestTransformComp>(EntityId{4});
+    assert(comps4.peek(&TestTransformComp::message) == "40");
+}
+
+inline void test_transformation_cache(CM &cm)
+{
+    PRINT("TESTING TRANSFORMATION CACHE")
+
+    using ECS::internal::Transformation;
+
+    size_t calls{};
+    int bonus{1};
+    cm.registerTransformation<TestHealthComponent>([&](EntityId eId, TestHealthComponent health) {
+        ++calls;
+        health.value += bonus;
+        return health;
+    });
+
+    for (EntityId id = 1; id <= 4; ++id)
+        cm.add<TestHealthComponent>(id, static_cast<int>(id));
+
+    auto transformed = [&](EntityId eId) {
+        auto [health] = cm.get<TestHealthComponent>(eId);
+        return health.peek(Transformation::TRANSFORM, &TestHealthComponent::value);
+    };
+
+    // Repeated reads only transform each entity once
+    for (int read = 0; read < 3; ++read)
+    {
+        for (EntityId id = 1; id <= 4; ++id)
+            assert(transformed(id) == static_cast<int>(id) + 1);
+    }
+    assert(calls == 4);
+
+    // Mutating or overwriting a component only recomputes that entity
+    auto [health2] = cm.get<TestHealthComponent>(EntityId{2});
+    health2.mutate([](TestHealthComponent &health) { health.value = 20; });
+    cm.overwrite<TestHealthComponent>(EntityId{3}, 30);
+    assert(transformed(2) == 21);
+    assert(transformed(3) == 31);
+    assert(transformed(4) == 5);
+    assert(calls == 6);
+
+    // So does mutating through filtered components
+    auto [health4] = cm.get<TestHealthComponent>(EntityId{4});
+    health4.filter([](const TestHealthComponent &health) { return true; })
+        .mutate([](TestHealthComponent &health) { health.value = 100; });
+    assert(transformed(4) == 101);
+    assert(calls == 7);
+    cm.overwrite<TestHealthComponent>(EntityId{4}, 4);
+
+    // Removing an entity moves another into its slot, which must not read the removed entity's cache
+    cm.remove<TestHealthComponent>(EntityId{1});
+    assert(transformed(4) == 5);
+    assert(transformed(2) == 21);
+
+    // State outside of the component needs an explicit invalidation
+    bonus = 100;
+    assert(transformed(2) == 21);
+    cm.invalidateTransformation<TestHealthComponent>();
+    assert(transformed(2) == 120);
+
+    // Registering again invalidates every cached result
+    cm.registerTransformation<TestHealthComponent>([](EntityId eId, TestHealthComponent health) {
+        health.value *= 2;
+        return health;
+    });
+    assert(transformed(4) == 8);
+
+    // Stacked components are cached per entity, and adding to the stack recomputes it
+    cm.registerTransformation<TestDamageComponent>([](EntityId eId, TestDamageComponent damage) {
+        damage.amount *= 10;
+        return damage;
+    });
+    cm.add<TestDamageComponent>(EntityId{1}, 1);
+    cm.add<TestDamageComponent>(EntityId{1}, 2);
+
+    auto transformedTotal = [&]() {
+        auto [damages] = cm.get<TestDamageComponent>(EntityId{1});
+        int total{};
+        damages.inspect([&](const TestDamageComponent &damage) { total += damage.amount; },
+                        Transformation::TRANSFORM);
+        return total;
+    };
+    assert(transformedTotal() == 30);
+    cm.add<TestDamageComponent>(EntityId{1}, 3);
+    assert(transformedTotal() == 60);
+}
+
+inline void test_transform_all(CM &cm)
+{
+    PRINT("TESTING TRANSFORM ALL")
+
+    constexpr int entityCount = 1000;
+
+    std::atomic<size_t> calls{};
+    cm.registerTransformation<TestTransformComp>([&](EntityId eId, TestTransformComp comp) {
+        ++calls;
+        comp.message = std::to_string(eId);
+        return comp;
+    });
+
+    // Sets without a transformation are left alone
+    cm.add<TestHealthComponent>(EntityId{1});
+    cm.transformAll<TestHealthComponent>();
+
+    for (EntityId id = 1; id <= entityCount; ++id)
+        cm.add<TestTransformComp>(id);
+
+    cm.transformAll<TestTransformComp>();
+    assert(calls == entityCount);
+
+    // Default reads of Transform tagged components use the results
+    auto [comps] = cm.getAll<TestTransformComp>();
+    comps.each([&](EntityId eId, auto &comp) {
+        assert(comp.peek(&TestTransformComp::message) == std::to_string(eId));
+    });
+    assert(calls == entityCount);
+
+    // Only the changed and the new entities are transformed again
+    cm.overwrite<TestTransformComp>(EntityId{5});
+    cm.add<TestTransformComp>(EntityId{entityCount + 1});
+    cm.parallelTransformAll<TestTransformComp>();
+    assert(calls == entityCount + 2);
+
+    auto [comps5] = cm.get<TestTransformComp>(EntityId{5});
+    assert(comps5.peek(&TestTransformComp::message) == "5");
+
+    // Every entity is transformed again once the transformation is replaced
+    cm.registerTransformation<TestTransformComp>([&](EntityId eId, TestTransformComp comp) {
+        ++calls;
+        comp.message = "replaced";
+        return comp;
+    });
+    calls = 0;
+    cm.parallelTransformAll<TestTransformComp>();
+    assert(calls == entityCount + 1);
+}